@@ -0,0 +1,20 @@
+// draws only the tiles whose cell is visible, the mask has one texel per cell in view, white if the player can see it
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D u_mask;
+
+varying vec2 v_maskCoord;
+
+void main() {
+    if (v_maskCoord.x < 0.0 || v_maskCoord.y < 0.0 || v_maskCoord.x > 1.0 || v_maskCoord.y > 1.0) {
+        discard; // chunk meshes reach past the view bounds
+    }
+    if (texture2D(u_mask, v_maskCoord).r < 0.5) {
+        discard;
+    }
+
+    gl_FragColor = gl_Color;
+}
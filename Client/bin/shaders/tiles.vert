@@ -0,0 +1,12 @@
+// tile chunk meshes are in world pixels, pass that position on so the fragment shader can look up its cell in the visibility mask
+
+uniform vec2 u_maskOrigin; // world pixel position of the top-left corner of the mask
+uniform vec2 u_maskSize; // size of the mask in world pixels
+
+varying vec2 v_maskCoord;
+
+void main() {
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_FrontColor = gl_Color;
+    v_maskCoord = (gl_Vertex.xy - u_maskOrigin) / u_maskSize;
+}
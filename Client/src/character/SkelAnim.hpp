@@ -3,7 +3,14 @@
 #include "Skeleton.hpp"
 #include "Bone.hpp"
 
-// a single skeletal animation (e.g., run)
+#include <array>
+#include <cstdint>
+
+/// @brief index of a SkelAnim in Assets
+using SkelAnimID = uint16_t;
+
+/// @brief a single skeletal animation (e.g., run), key frames shared by every entity playing it
+/// @note never modified once made, the pose being played lives in CSkelAnim
 class SkelAnim
 {
 public:
@@ -14,15 +21,15 @@ public:
         : m_keyFrames(keyFrames)
     { }
 
-    /// @brief interpolate between two key frames to update current skeleton
-    void update(float timeSinceLastKeyFrame)
+    /// @brief interpolate between key frame lastKeyFrameIdx and the next one into pose
+    void sample(size_t lastKeyFrameIdx, float timeSinceLastKeyFrame, Skeleton& pose) const
     {
         float frac = timeSinceLastKeyFrame / m_frameDuration;
-        size_t nextKeyFrameIdx = (m_lastKeyFrameIdx + 1) % m_keyFrames.size();
+        size_t nextKeyFrameIdx = (lastKeyFrameIdx + 1) % m_keyFrames.size();
 
-        const std::array<Bone, 7>& lastKeyFrameBones = m_keyFrames[m_lastKeyFrameIdx].getBones();
+        const std::array<Bone, 7>& lastKeyFrameBones = m_keyFrames[lastKeyFrameIdx].getBones();
         const std::array<Bone, 7>& nextKeyFrameBones = m_keyFrames[nextKeyFrameIdx].getBones();
-        std::array<Bone, 7>& currentFrameBones = m_currentFrame.getBones();
+        std::array<Bone, 7>& currentFrameBones = pose.getBones();
 
         for (size_t i = 0; i < currentFrameBones.size(); ++i)
         {
@@ -31,16 +38,9 @@ public:
         }
     }
 
-    Skeleton& getCurrentFrame()
-    {
-        return m_currentFrame;
-    }
-
 private:
 
-    Skeleton m_currentFrame; // current skeleton
     std::array<Skeleton, 10> m_keyFrames;
-    size_t m_lastKeyFrameIdx = 0;
 
     float m_frameDuration = 0.1f; // duration of each key frame (seconds)
 };
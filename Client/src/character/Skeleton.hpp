@@ -27,6 +27,11 @@ public:
         return m_bones;
     }
 
+    const std::array<Bone, 7>& getBones() const
+    {
+        return m_bones;
+    }
+
 private:
 
     // at some time t, m_bones holds the exact positions of the bones of the skeleton (whether this is a key frame or an interpolation)
@@ -10,49 +10,48 @@
 
 // C++ standard libraries
 #include <string>
+#include <cstdint>
 
+/// @brief index of an Animation in Assets, what components store instead of the animation itself
+using AnimationID = uint16_t;
+
+/// @brief an animation asset, shared and never modified once loaded, per-entity playback state lives in CAnimation
+/// @note holds a pointer to a texture owned by Assets, so copying one never copies pixels
 class Animation
 {
 public:
-    /// @brief default constructor needed for memory pool initialization (Animation part of CAnimation)
     Animation() = default;
 
     /// @brief construct animation with a single image file with frames of animation equally spaced horizontally
     Animation(const std::string& name, const sf::Texture& texture, int frameCount, int frameDuration)
-        : m_name(name), m_frameCount(frameCount), m_frameDuration(frameDuration), m_texture(texture)
+        : m_name(name), m_frameCount(frameCount), m_frameDuration(frameDuration), m_texture(&texture)
     {
-        m_size = { static_cast<int>(m_texture.getSize().x), static_cast<int>(m_texture.getSize().y) };
-        m_sprite.setOrigin(sf::Vector2f { m_size.x / 2.0f, m_size.y / 2.0f });
-        m_sprite.setTexture(texture);
-        m_sprite.setTextureRect(sf::IntRect { { m_currentFrame * m_size.x, 0 }, { m_size.x, m_size.y } });
+        m_size = { static_cast<int>(texture.getSize().x), static_cast<int>(texture.getSize().y) };
     }
 
     /// @brief construct a 1-frame "animation" from a region in a texture atlas
     Animation(const std::string& name, const sf::Texture& texture, const Vec2i& atlasPosition, const Vec2i& size)
-        : m_name(name), m_atlasPosition(atlasPosition), m_size(size), m_texture(texture)
-    {
-        m_sprite.setOrigin({ size.x / 2.0f, size.y / 2.0f });
-        m_sprite.setTexture(texture);
-        m_sprite.setTextureRect(sf::IntRect({ atlasPosition.x, atlasPosition.y }, { size.x, size.y }));
-    }
+        : m_name(name), m_atlasPosition(atlasPosition), m_size(size), m_texture(&texture)
+    { }
 
-    /// @brief advances an animation by one frame
-    void updateLoop()
+    /// @brief the animation frame shown after gameFramesPassed game frames, looping past the last frame
+    int getFrame(int gameFramesPassed) const
     {
-        ++m_gameFramesPassed;
-        m_currentFrame = (m_gameFramesPassed / m_frameDuration) % m_frameCount; // if frameCount < (m_gameFramesPassed / m_frameDuration), then this animation is looping
-        m_sprite.setTextureRect(sf::IntRect({ m_currentFrame * m_size.x, 0 }, { m_size.x, m_size.y }));
+        return (gameFramesPassed / m_frameDuration) % m_frameCount;
     }
 
-    /// @brief determines if a non-looping animation has ended
-    bool hasEnded() const
+    /// @brief determines if a non-looping animation has ended after gameFramesPassed game frames
+    bool hasEnded(int gameFramesPassed) const
     {
-        return (m_gameFramesPassed / m_frameDuration > m_currentFrame);
+        return gameFramesPassed / m_frameDuration >= m_frameCount;
     }
 
-    sf::Sprite& getSprite()
+    /// @brief a sprite showing frame, centered on its origin, sprites only point at the texture so this allocates nothing
+    sf::Sprite makeSprite(int frame) const
     {
-        return m_sprite;
+        sf::Sprite sprite(*m_texture, sf::IntRect({ m_atlasPosition.x + frame * m_size.x, m_atlasPosition.y }, { m_size.x, m_size.y }));
+        sprite.setOrigin({ m_size.x / 2.0f, m_size.y / 2.0f });
+        return sprite;
     }
 
     const std::string& getName() const
@@ -68,12 +67,9 @@ public:
 private:
 
     std::string m_name;
-    int m_frameCount; // number of animation frames in the animation
-    int m_frameDuration; // number of game frames in one animation frame
+    int m_frameCount = 1; // number of animation frames in the animation
+    int m_frameDuration = 1; // number of game frames in one animation frame
     Vec2i m_atlasPosition; // for regions of texture atlases
     Vec2i m_size; // dimensions of one animation frame
-    int m_currentFrame = 0; // current frame of the animation
-    int m_gameFramesPassed; // number of game frames passed since created
-    sf::Texture m_texture; // texture used for sprite
-    sf::Sprite m_sprite = sf::Sprite(m_texture); /// TODO: may be a better way to fix this defualt constructor problem than using a default texture and just replacing it
+    const sf::Texture* m_texture = nullptr; // owned by Assets
 };
@@ -0,0 +1,124 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+// Core
+#include "ArchetypePool.hpp"
+
+ArchetypePool::ArchetypePool(EntityID maxEntities)
+    : m_records(maxEntities),
+    m_slots(maxEntities)
+{
+    m_archetypes.emplace_back(); // no components
+}
+
+EntityID ArchetypePool::addEntity()
+{
+    // find index, growing by a page if every slot is taken
+    if (m_slots.isFull())
+    {
+        reserve(m_slots.getCapacity() + EntitySlots::pageSize);
+    }
+    const EntityID index = m_slots.allocate();
+
+    // drop whatever the previous entity at index had, and start over in the archetype without components
+    detach(index, npos);
+    m_records[index] = { 0, static_cast<uint32_t>(m_archetypes[0].entities.size()) };
+    m_archetypes[0].entities.push_back(index);
+
+    return index;
+}
+
+/// @brief remove an entity from the pool, its components stay readable until its slot is reused
+void ArchetypePool::removeEntity(EntityID entityID, uint32_t generation)
+{
+    m_slots.release(entityID, generation);
+}
+
+void ArchetypePool::reserve(EntityID capacity)
+{
+    if (capacity > m_slots.getCapacity())
+    {
+        m_records.resize(capacity);
+        m_slots.grow(capacity);
+    }
+}
+
+bool ArchetypePool::isAlive(EntityID entityID, uint32_t generation) const
+{
+    return m_slots.isAlive(entityID, generation);
+}
+
+uint32_t ArchetypePool::getGeneration(EntityID entityID) const
+{
+    return m_slots.getGeneration(entityID);
+}
+
+uint32_t ArchetypePool::getRemoveEdge(uint32_t source, size_t index)
+{
+    if (m_archetypes[source].removeEdges[index] != npos)
+    {
+        return m_archetypes[source].removeEdges[index];
+    }
+
+    const uint32_t signature = m_archetypes[source].signature & ~(uint32_t { 1 } << index);
+    uint32_t target = npos;
+    for (uint32_t i = 0; i < m_archetypes.size(); ++i)
+    {
+        if (m_archetypes[i].signature == signature)
+        {
+            target = i;
+            break;
+        }
+    }
+
+    if (target == npos)
+    {
+        Archetype archetype;
+        archetype.signature = signature;
+        for (size_t c = 0; c < numComponents; ++c)
+        {
+            if (c != index && m_archetypes[source].columns[c])
+            {
+                archetype.columns[c] = m_archetypes[source].columns[c]->makeEmpty();
+            }
+        }
+
+        target = static_cast<uint32_t>(m_archetypes.size());
+        m_archetypes.push_back(std::move(archetype));
+    }
+
+    m_archetypes[source].removeEdges[index] = target;
+    return target;
+}
+
+void ArchetypePool::detach(EntityID entityID, uint32_t target)
+{
+    const Record record = m_records[entityID];
+    if (record.archetype == npos)
+    {
+        return;
+    }
+
+    Archetype& source = m_archetypes[record.archetype];
+    for (size_t c = 0; c < numComponents; ++c)
+    {
+        if (!source.columns[c])
+        {
+            continue;
+        }
+        if (target != npos && m_archetypes[target].columns[c])
+        {
+            source.columns[c]->moveRowTo(record.row, *m_archetypes[target].columns[c]);
+        }
+        source.columns[c]->swapRemove(record.row);
+    }
+
+    // the last row was moved into this one
+    const EntityID last = source.entities.back();
+    source.entities[record.row] = last;
+    source.entities.pop_back();
+    if (last != entityID)
+    {
+        m_records[last].row = record.row;
+    }
+    m_records[entityID].archetype = npos;
+}
@@ -0,0 +1,420 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Core
+#include "Components.hpp"
+#include "EntitySlots.hpp"
+#include "PagedVector.hpp"
+
+// Utility
+#include "utility/ClientGlobals.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <array>
+#include <tuple>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+
+/// @brief every component type the archetype pool can store, a component's index here is its bit in an archetype signature
+using ArchetypeComponents = std::tuple<
+    CAnimation,
+    CTransform,
+    CBoundingBox,
+    CHealth,
+    CLifespan,
+    CDamage,
+    CInvincibility,
+    CInput,
+    CGravity,
+    CState,
+    CFire,
+    CJointRelation,
+    CJointInfo,
+    CSkelAnim
+>;
+
+template <typename T, typename Tuple>
+struct TupleIndex;
+
+template <typename T, typename... Ts>
+struct TupleIndex<T, std::tuple<T, Ts...>>
+{
+    static constexpr size_t value = 0;
+};
+
+template <typename T, typename U, typename... Ts>
+struct TupleIndex<T, std::tuple<U, Ts...>>
+{
+    static constexpr size_t value = 1 + TupleIndex<T, std::tuple<Ts...>>::value;
+};
+
+/// @brief entities grouped by component signature, each archetype keeps one packed column per component and a row per entity
+/// @note bullets, ragdoll parts, and body parts each end up in one archetype, so a system sweeping them reads packed arrays instead of one slot per entity in 14 storages
+/// adding or removing a component moves the entity's row to the archetype with that component added or removed (cached per archetype and component), and the last row of the archetype it left takes its place
+/// so a structural change invalidates references to the moved entity's components and to those of the entity swapped into its old row, columns are paged so references to every other entity's components stay valid
+/// reusing a removed entity's slot takes its old row out the same way, so it too can move the last entity of that archetype
+/// like EntityMemoryPool, an entity's components live until its slot is reused, not until it is removed
+class ArchetypePool
+{
+    template <typename T>
+    struct Column; // one component type's data in an archetype, defined with the other storage types below
+
+public:
+
+    static constexpr size_t numComponents = std::tuple_size_v<ArchetypeComponents>;
+    static_assert(numComponents <= 32, "archetype signatures are 32 bits");
+
+    template <typename T>
+    static constexpr uint32_t componentBit = uint32_t { 1 } << TupleIndex<T, ArchetypeComponents>::value;
+
+    explicit ArchetypePool(EntityID maxEntities);
+
+    ArchetypePool(const ArchetypePool&) = delete;
+    ArchetypePool& operator=(const ArchetypePool&) = delete;
+
+    /// @brief entityID's component of type T, marked changed on the current tick since the caller can write it
+    template <typename T>
+    T& getComponent(EntityID entityID)
+    {
+        const Record& record = m_records[entityID];
+        Column<T>& col = column<T>(m_archetypes[record.archetype]);
+        col.versions[record.row] = m_tick;
+        return col.data[record.row];
+    }
+
+    /// @brief entityID's component of type T without marking it changed
+    template <typename T>
+    const T& readComponent(EntityID entityID)
+    {
+        const Record& record = m_records[entityID];
+        return column<T>(m_archetypes[record.archetype]).data[record.row];
+    }
+
+    /// @brief whether entityID's component of type T was added or accessed mutably after tick, it must have one
+    template <typename T>
+    bool hasChangedSince(EntityID entityID, uint32_t tick) const
+    {
+        const Record& record = m_records[entityID];
+        return column<T>(m_archetypes[record.archetype]).versions[record.row] > tick;
+    }
+
+    uint32_t getTick() const
+    {
+        return m_tick;
+    }
+
+    /// @brief start a new tick, call once per simulation step before any system runs
+    void advanceTick()
+    {
+        ++m_tick;
+    }
+
+    template <typename T>
+    bool hasComponent(EntityID entityID)
+    {
+        const uint32_t archetype = m_records[entityID].archetype;
+        return archetype != npos && (m_archetypes[archetype].signature & componentBit<T>);
+    }
+
+    /// @brief add a component of type T with arguments mArgs of types TArgs to entity entityID, replacing it if the entity already has one
+    /// @return the added component
+    /// @note unless the entity already has a T, this moves its row, see the class note for which references that invalidates
+    template <typename T, typename... TArgs>
+    T& addComponent(EntityID entityID, TArgs &&...mArgs)
+    {
+        T component(std::forward<TArgs>(mArgs)...);
+        component.exists = true;
+
+        Record& record = m_records[entityID];
+        if (hasComponent<T>(entityID))
+        {
+            Column<T>& col = column<T>(m_archetypes[record.archetype]);
+            col.versions[record.row] = m_tick;
+            return col.data[record.row] = std::move(component);
+        }
+
+        const uint32_t target = getAddEdge(record.archetype, TupleIndex<T, ArchetypeComponents>::value, [] { return std::make_unique<Column<T>>(); });
+        moveEntity(entityID, target);
+        Column<T>& col = column<T>(m_archetypes[target]);
+        col.versions.push_back(m_tick);
+        col.data.push_back(std::move(component));
+        return col.data.back();
+    }
+
+    /// @brief remove entityID's component of type T, if it has one, by moving its row to the archetype without T
+    /// @note like addComponent, this moves the entity's row and the last row of its old archetype, see the class note
+    template <typename T>
+    void removeComponent(EntityID entityID)
+    {
+        if (hasComponent<T>(entityID))
+        {
+            moveEntity(entityID, getRemoveEdge(m_records[entityID].archetype, TupleIndex<T, ArchetypeComponents>::value));
+        }
+    }
+
+    /// @brief calls f(EntityID, Cs&...) for every active entity with all of Cs, or f(entity, Cs&...) for every one in a list, like ComponentView
+    /// @note as with ComponentView, components in Cs that aren't const get touched on every visit
+    template <typename... Cs>
+    class View
+    {
+    public:
+
+        explicit View(ArchetypePool& pool)
+            : m_pool(pool)
+        { }
+
+        template <typename F>
+        void each(F&& f)
+        {
+            sweep(f, [](const Columns&, size_t) { return true; });
+        }
+
+        /// @brief like each, but only for the entities whose T was added or accessed mutably after tick, T must be one of Cs, like ComponentView::eachChangedSince
+        template <typename T, typename F>
+        void eachChangedSince(uint32_t tick, F&& f)
+        {
+            static_assert((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Cs>> || ...), "T must be one of the view's components");
+            sweep(f, [tick](const Columns& columns, size_t row) { return std::get<Column<std::remove_const_t<T>>*>(columns)->versions[row] > tick; });
+        }
+
+        template <typename EntityList, typename F>
+        void each(EntityList& entities, F&& f)
+        {
+            for (auto& entity : entities)
+            {
+                const EntityID id = entity.getID();
+                if (m_pool.m_slots.isActive(id) && (m_pool.hasComponent<std::remove_const_t<Cs>>(id) && ...))
+                {
+                    f(entity, access<Cs>(column<std::remove_const_t<Cs>>(m_pool.m_archetypes[m_pool.m_records[id].archetype]), m_pool.m_records[id].row)...);
+                }
+            }
+        }
+
+    private:
+
+        using Columns = std::tuple<Column<std::remove_const_t<Cs>>*...>;
+
+        ArchetypePool& m_pool;
+
+        /// @brief call f(EntityID, Cs&...) for every active entity with all of Cs whose row passes filter(columns, row)
+        template <typename F, typename Filter>
+        void sweep(F& f, Filter&& filter)
+        {
+            constexpr uint32_t required = (componentBit<std::remove_const_t<Cs>> | ...);
+            for (Archetype& archetype : m_pool.m_archetypes)
+            {
+                if ((archetype.signature & required) != required)
+                {
+                    continue;
+                }
+
+                // resolve every column once per archetype, then sweep the rows
+                Columns columns { &column<std::remove_const_t<Cs>>(archetype)... };
+                const std::vector<EntityID>& entities = archetype.entities;
+                for (size_t row = 0; row < entities.size(); ++row)
+                {
+                    if (m_pool.m_slots.isActive(entities[row]) && filter(columns, row))
+                    {
+                        f(entities[row], access<Cs>(*std::get<Column<std::remove_const_t<Cs>>*>(columns), row)...);
+                    }
+                }
+            }
+        }
+
+        template <typename C>
+        C& access(Column<std::remove_const_t<C>>& col, size_t row)
+        {
+            if constexpr (!std::is_const_v<C>)
+            {
+                col.versions[row] = m_pool.m_tick;
+            }
+            return col.data[row];
+        }
+    };
+
+    template <typename... Cs>
+    View<Cs...> view()
+    {
+        return View<Cs...>(*this);
+    }
+
+    EntityID addEntity();
+    void removeEntity(EntityID entityID, uint32_t generation);
+    bool isAlive(EntityID entityID, uint32_t generation) const;
+    uint32_t getGeneration(EntityID entityID) const;
+
+    /// @brief make room for at least capacity entities, components live in the archetype tables so only the per-entity records grow
+    void reserve(EntityID capacity);
+
+    EntityID getCapacity() const
+    {
+        return m_slots.getCapacity();
+    }
+
+    EntityID getHighWaterMark() const
+    {
+        return m_slots.getHighWaterMark();
+    }
+
+    /// @brief IDs of the entities removed since the last clearDestroyed, see EntitySlots
+    const std::vector<EntityID>& getDestroyed() const
+    {
+        return m_slots.getDestroyed();
+    }
+
+    void clearDestroyed()
+    {
+        m_slots.clearDestroyed();
+    }
+
+    size_t getArchetypeCount() const
+    {
+        return m_archetypes.size();
+    }
+
+private:
+
+    struct ColumnBase
+    {
+        virtual ~ColumnBase() = default;
+        virtual std::unique_ptr<ColumnBase> makeEmpty() const = 0;
+        virtual void moveRowTo(size_t row, ColumnBase& destination) = 0; // appends
+        virtual void swapRemove(size_t row) = 0;
+    };
+
+    template <typename T>
+    struct Column : ColumnBase
+    {
+        PagedVector<T> data; // paged so appending a row never moves the others
+        PagedVector<uint32_t> versions; // tick each row's component was last touched on
+
+        std::unique_ptr<ColumnBase> makeEmpty() const override
+        {
+            return std::make_unique<Column<T>>();
+        }
+
+        void moveRowTo(size_t row, ColumnBase& destination) override
+        {
+            Column<T>& target = static_cast<Column<T>&>(destination);
+            target.data.push_back(std::move(data[row]));
+            target.versions.push_back(versions[row]);
+        }
+
+        void swapRemove(size_t row) override
+        {
+            if (row != data.size() - 1)
+            {
+                data[row] = std::move(data.back());
+                versions[row] = versions.back();
+            }
+            data.pop_back();
+            versions.pop_back();
+        }
+    };
+
+    struct Archetype
+    {
+        uint32_t signature = 0;
+        std::array<std::unique_ptr<ColumnBase>, numComponents> columns; // null for components not in the signature
+        std::array<uint32_t, numComponents> addEdges; // archetype with one more component, npos until first used
+        std::array<uint32_t, numComponents> removeEdges; // archetype with one less component, npos until first used
+        std::vector<EntityID> entities; // owner of each row
+
+        Archetype()
+        {
+            addEdges.fill(npos);
+            removeEdges.fill(npos);
+        }
+    };
+
+    struct Record
+    {
+        uint32_t archetype = npos; // npos for slots that were never used
+        uint32_t row = 0;
+    };
+
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Archetype> m_archetypes; // [0] has no components, new entities start there
+    std::vector<Record> m_records; // indexed by entity ID
+    EntitySlots m_slots;
+    uint32_t m_tick = 1; // stamped on components as they're written, 0 means never written
+
+    template <typename T>
+    static Column<T>& column(Archetype& archetype)
+    {
+        constexpr size_t index = TupleIndex<T, ArchetypeComponents>::value;
+        assert(archetype.columns[index]);
+        return static_cast<Column<T>&>(*archetype.columns[index]);
+    }
+
+    template <typename T>
+    static const Column<T>& column(const Archetype& archetype)
+    {
+        constexpr size_t index = TupleIndex<T, ArchetypeComponents>::value;
+        assert(archetype.columns[index]);
+        return static_cast<const Column<T>&>(*archetype.columns[index]);
+    }
+
+    /// @brief the archetype of source's signature plus component index, created the first time it's needed
+    /// @param makeColumn creates an empty column for the added component, the others are cloned from source
+    template <typename MakeColumn>
+    uint32_t getAddEdge(uint32_t source, size_t index, MakeColumn&& makeColumn)
+    {
+        if (m_archetypes[source].addEdges[index] != npos)
+        {
+            return m_archetypes[source].addEdges[index];
+        }
+
+        const uint32_t signature = m_archetypes[source].signature | (uint32_t { 1 } << index);
+        uint32_t target = npos;
+        for (uint32_t i = 0; i < m_archetypes.size(); ++i)
+        {
+            if (m_archetypes[i].signature == signature)
+            {
+                target = i;
+                break;
+            }
+        }
+
+        if (target == npos)
+        {
+            Archetype archetype;
+            archetype.signature = signature;
+            for (size_t c = 0; c < numComponents; ++c)
+            {
+                if (m_archetypes[source].columns[c])
+                {
+                    archetype.columns[c] = m_archetypes[source].columns[c]->makeEmpty();
+                }
+            }
+            archetype.columns[index] = makeColumn();
+
+            target = static_cast<uint32_t>(m_archetypes.size());
+            m_archetypes.push_back(std::move(archetype)); // source may have moved, index it again below
+        }
+
+        m_archetypes[source].addEdges[index] = target;
+        return target;
+    }
+
+    /// @brief the archetype of source's signature minus component index, created the first time it's needed
+    uint32_t getRemoveEdge(uint32_t source, size_t index);
+
+    /// @brief take entityID's row out of its archetype, moving its components into target if given, and fix the row of the entity swapped into its place
+    void detach(EntityID entityID, uint32_t target);
+
+    /// @brief move entityID's components that target also has into a new row of target, the rest are dropped
+    void moveEntity(EntityID entityID, uint32_t target)
+    {
+        detach(entityID, target);
+        m_records[entityID] = { target, static_cast<uint32_t>(m_archetypes[target].entities.size()) };
+        m_archetypes[target].entities.push_back(entityID);
+    }
+};
@@ -7,8 +7,8 @@
 // Core
 #include "Animation.hpp"
 
-// Physics
-// #include "physics/SkelAnim.hpp"
+// Character
+#include "character/SkelAnim.hpp"
 
 // External libraries
 #include <SFML/Graphics.hpp>
@@ -19,12 +19,20 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <vector>
 #include <optional>
 
+/// @brief owns every texture, animation, font, and sound
+/// @note animations are stored once here and components refer to them by ID, so entities never copy an animation
 class Assets
 {
 public:
 
+    Assets()
+    {
+        addSkelAnim("Walk", AnimConfig::walkKeyFrames);
+    }
+
     /// @brief loads all assets from asset configuration file
     /// @param path the file path to the asset configuration file
     void loadFromFile(const std::string& path)
@@ -87,17 +95,35 @@ public:
         return m_textureMap.at(textureName);
     }
 
-    Animation& getAnimation(const std::string& animationName)
+    /// @brief look up an animation's ID by name, do this once at spawn or load time, not per frame
+    AnimationID getAnimationID(const std::string& animationName) const
     {
-        assert(m_animationMap.find(animationName) != m_animationMap.end());
-        return m_animationMap.at(animationName);
+        assert(m_animationIDs.find(animationName) != m_animationIDs.end());
+        return m_animationIDs.at(animationName);
     }
 
-    // const SkelAnim& getSkelAnim(const std::string& animationName) const
-    // {
-    //     assert(m_skelAnimMap.find(animationName) != m_skelAnimMap.end());
-    //     return m_skelAnimMap.at(animationName);
-    // }
+    const Animation& getAnimation(AnimationID id) const
+    {
+        assert(id < m_animations.size());
+        return m_animations[id];
+    }
+
+    const Animation& getAnimation(const std::string& animationName) const
+    {
+        return getAnimation(getAnimationID(animationName));
+    }
+
+    SkelAnimID getSkelAnimID(const std::string& animationName) const
+    {
+        assert(m_skelAnimIDs.find(animationName) != m_skelAnimIDs.end());
+        return m_skelAnimIDs.at(animationName);
+    }
+
+    const SkelAnim& getSkelAnim(SkelAnimID id) const
+    {
+        assert(id < m_skelAnims.size());
+        return m_skelAnims[id];
+    }
 
     const sf::Font& getFont(const std::string& fontName) const
     {
@@ -110,9 +136,9 @@ public:
         return m_textureMap;
     }
 
-    const std::map<std::string, Animation>& getAnimations() const
+    const std::vector<Animation>& getAnimations() const
     {
-        return m_animationMap;
+        return m_animations;
     }
 
     // sf::Sound& getSound(const std::string& soundName)
@@ -129,9 +155,11 @@ public:
 
 private:
 
-    std::map<std::string, sf::Texture> m_textureMap;
-    std::map<std::string, Animation> m_animationMap;
-    // std::map<std::string, SkelAnim> m_skelAnimMap;
+    std::map<std::string, sf::Texture> m_textureMap; // map nodes never move, so animations can point at their textures
+    std::vector<Animation> m_animations; // indexed by AnimationID
+    std::map<std::string, AnimationID> m_animationIDs;
+    std::vector<SkelAnim> m_skelAnims; // indexed by SkelAnimID
+    std::map<std::string, SkelAnimID> m_skelAnimIDs;
     std::map<std::string, sf::Font> m_fontMap;
     std::map<std::string, sf::SoundBuffer> m_soundBufferMap;
     std::map<std::string, std::optional<sf::Sound>> m_soundMap; // made this optional because of the lack of a default constructor
@@ -161,7 +189,7 @@ private:
     /// @param frameDuration number of game frames to maintain each animation frame
     void addAnimation(const std::string& animationName, const std::string& textureName, int frameCount, int frameDuration)
     {
-        m_animationMap[animationName] = Animation(animationName, getTexture(textureName), frameCount, frameDuration);
+        storeAnimation(Animation(animationName, getTexture(textureName), frameCount, frameDuration));
     }
 
     /// @brief add a sprite to the animation map
@@ -170,7 +198,28 @@ private:
     /// @param size size in pixels of texture region
     void addAnimation(const std::string& spriteName, const std::string& textureName, const Vec2i& position, const Vec2i& size)
     {
-        m_animationMap[spriteName] = Animation(spriteName, getTexture(textureName), position, size);
+        storeAnimation(Animation(spriteName, getTexture(textureName), position, size));
+    }
+
+    /// @brief add animation under its name, replacing one already loaded with that name so existing IDs stay valid
+    void storeAnimation(Animation&& animation)
+    {
+        auto it = m_animationIDs.find(animation.getName());
+        if (it != m_animationIDs.end())
+        {
+            m_animations[it->second] = std::move(animation);
+            return;
+        }
+
+        m_animationIDs[animation.getName()] = static_cast<AnimationID>(m_animations.size());
+        m_animations.push_back(std::move(animation));
+    }
+
+    /// @brief add a skeletal animation to the skeletal animation list
+    void addSkelAnim(const std::string& animationName, const std::array<Skeleton, 10>& keyFrames)
+    {
+        m_skelAnimIDs[animationName] = static_cast<SkelAnimID>(m_skelAnims.size());
+        m_skelAnims.emplace_back(keyFrames);
     }
 
     /// @brief add a font to the font map
@@ -0,0 +1,36 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+// Core
+#include "CommandBuffer.hpp"
+#include "EntityManager.hpp"
+
+void CommandBuffer::playback(EntityManager& entityManager)
+{
+    PROFILE_FUNCTION();
+
+    m_spawned.clear();
+    for (const Command& command : m_commands)
+    {
+        if (command.kind == Kind::SPAWN)
+        {
+            m_spawned.push_back(entityManager.addEntity(command.type));
+            continue;
+        }
+
+        Entity entity = command.spawned == npos ? entityManager.getEntity(command.target) : m_spawned[command.spawned];
+        if (!entity.isActive()) // destroyed earlier in this buffer, another buffer, or before playback
+        {
+            continue;
+        }
+
+        if (command.kind == Kind::DESTROY)
+        {
+            entity.destroy();
+        }
+        else
+        {
+            command.apply(entity, m_payloads.data() + command.payload);
+        }
+    }
+    clear();
+}
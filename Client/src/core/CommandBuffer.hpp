@@ -0,0 +1,149 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Core
+#include "Entity.hpp"
+
+// Global
+#include "EntityBase.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+class EntityManager;
+
+/// @brief structural changes (spawn, destroy, add or remove a component) recorded by systems and applied together at a sync point, see EntityManager::update
+/// @note recording never touches the world, so a system can record while it iterates a view, and worker threads can each record into their own buffer
+/// commands are played back in the order they were recorded, and ones aimed at an entity destroyed before they run are dropped
+/// components are copied into a byte buffer, so recording allocates nothing once the buffer has grown to a frame's worth of commands
+class CommandBuffer
+{
+public:
+
+    /// @brief an entity spawned by this buffer, it doesn't exist until playback, so it can only be the target of commands in the same buffer
+    struct Spawned
+    {
+        uint32_t index = 0; // spawn number within the buffer
+    };
+
+    /// @brief spawn an entity of type at playback, it joins its type list in the same EntityManager::update
+    Spawned spawn(Entity::Type type)
+    {
+        Command& command = m_commands.emplace_back();
+        command.kind = Kind::SPAWN;
+        command.type = type;
+        return { m_spawnCount++ };
+    }
+
+    /// @brief destroy the entity handle refers to at playback, does nothing if it's already gone by then
+    void destroy(const EntityHandle& handle)
+    {
+        Command& command = m_commands.emplace_back();
+        command.kind = Kind::DESTROY;
+        command.target = handle;
+    }
+
+    /// @brief add a component of type T constructed from mArgs to the entity handle refers to at playback, replacing one it already has
+    template <typename T, typename... TArgs>
+    void addComponent(const EntityHandle& handle, TArgs &&...mArgs)
+    {
+        Command command;
+        command.target = handle;
+        recordAdd(command, T(std::forward<TArgs>(mArgs)...));
+    }
+
+    /// @brief add a component of type T constructed from mArgs to an entity spawned by this buffer
+    template <typename T, typename... TArgs>
+    void addComponent(Spawned spawned, TArgs &&...mArgs)
+    {
+        Command command;
+        command.spawned = spawned.index;
+        recordAdd(command, T(std::forward<TArgs>(mArgs)...));
+    }
+
+    /// @brief remove the component of type T from the entity handle refers to at playback, if it has one
+    template <typename T>
+    void removeComponent(const EntityHandle& handle)
+    {
+        Command& command = m_commands.emplace_back();
+        command.target = handle;
+        command.apply = &applyRemove<T>;
+    }
+
+    bool empty() const
+    {
+        return m_commands.empty();
+    }
+
+    /// @brief apply every recorded command in order, then clear the buffer, only call at a sync point with no system running
+    void playback(EntityManager& entityManager);
+
+    /// @brief drop every recorded command without applying it, keeping the memory for the next frame
+    void clear()
+    {
+        m_commands.clear();
+        m_payloads.clear();
+        m_spawnCount = 0;
+    }
+
+private:
+
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    enum class Kind : uint8_t
+    {
+        SPAWN,
+        DESTROY,
+        COMPONENT
+    };
+
+    using Apply = void (*)(Entity&, const std::byte*); // adds or removes one component type, given the command's payload
+
+    struct Command
+    {
+        Kind kind = Kind::COMPONENT; // the default, adds and removes differ only in apply
+        Entity::Type type = Entity::Type::NUM_TYPES; // for SPAWN
+        EntityHandle target; // entity the command applies to, unless spawned is set
+        uint32_t spawned = npos; // spawn number of the target if it was spawned by this buffer
+        uint32_t payload = 0; // offset of the component in m_payloads
+        Apply apply = nullptr; // for COMPONENT
+    };
+
+    std::vector<Command> m_commands;
+    std::vector<std::byte> m_payloads; // components to add, copied in as bytes
+    std::vector<Entity> m_spawned; // entities spawned so far during playback, indexed by spawn number
+    uint32_t m_spawnCount = 0;
+
+    template <typename T>
+    void recordAdd(Command command, const T& component)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "components recorded into a command buffer are copied as bytes");
+
+        command.payload = static_cast<uint32_t>(m_payloads.size());
+        command.apply = &applyAdd<T>;
+        m_payloads.resize(m_payloads.size() + sizeof(T));
+        std::memcpy(m_payloads.data() + command.payload, &component, sizeof(T));
+        m_commands.push_back(command);
+    }
+
+    template <typename T>
+    static void applyAdd(Entity& entity, const std::byte* payload)
+    {
+        T component;
+        std::memcpy(&component, payload, sizeof(T));
+        entity.addComponent<T>(std::move(component));
+    }
+
+    template <typename T>
+    static void applyRemove(Entity& entity, const std::byte*)
+    {
+        entity.removeComponent<T>();
+    }
+};
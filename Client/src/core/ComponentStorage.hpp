@@ -0,0 +1,178 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Core
+#include "Components.hpp"
+#include "PagedVector.hpp"
+
+// Global
+#include "EntityBase.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <cassert>
+#include <cstdint>
+
+/// @brief one slot per entity, exists flags mark which slots hold a component
+/// @note fastest access, but every entity pays for the component and iterating it means scanning every slot
+/// slots are paged, so growing the pool never moves a component
+/// each slot also has a version, the world tick it was last touched (added or accessed mutably) on
+template <typename T>
+class DenseStorage
+{
+public:
+
+    /// @brief make room for entity IDs up to maxEntities, never shrinks
+    void resize(EntityID maxEntities)
+    {
+        m_components.resize(maxEntities);
+        m_versions.resize(maxEntities);
+    }
+
+    bool has(EntityID entityID) const
+    {
+        return m_components[entityID].exists;
+    }
+
+    T& get(EntityID entityID)
+    {
+        return m_components[entityID];
+    }
+
+    T& add(EntityID entityID, T&& component)
+    {
+        T& slot = m_components[entityID];
+        slot = std::move(component);
+        slot.exists = true;
+        return slot;
+    }
+
+    /// @brief drop entityID's component, if it has one
+    void remove(EntityID entityID)
+    {
+        m_components[entityID].exists = false;
+    }
+
+    /// @brief record that entityID's component was written on tick
+    void touch(EntityID entityID, uint32_t tick)
+    {
+        m_versions[entityID] = tick;
+    }
+
+    uint32_t getVersion(EntityID entityID) const
+    {
+        return m_versions[entityID];
+    }
+
+private:
+
+    PagedVector<T> m_components; // indexed by entity ID
+    PagedVector<uint32_t> m_versions; // indexed by entity ID
+};
+
+/// @brief components packed densely in insertion order, plus a sparse entity ID -> packed index table
+/// @note only entities that have the component pay for it, and iterating it touches only those, removal is swap-and-pop so order isn't stable
+/// the packed components are paged, so adding one never moves the others, removing one moves the last into its place
+/// each packed component also has a version, the world tick it was last touched (added or accessed mutably) on
+template <typename T>
+class SparseStorage
+{
+public:
+
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    /// @brief make room for entity IDs up to maxEntities, never shrinks
+    void resize(EntityID maxEntities)
+    {
+        if (maxEntities > m_sparse.size())
+        {
+            m_sparse.resize(maxEntities, npos);
+        }
+    }
+
+    bool has(EntityID entityID) const
+    {
+        return m_sparse[entityID] != npos;
+    }
+
+    T& get(EntityID entityID)
+    {
+        assert(has(entityID));
+        return m_dense[m_sparse[entityID]];
+    }
+
+    T& add(EntityID entityID, T&& component)
+    {
+        component.exists = true;
+        if (has(entityID))
+        {
+            return m_dense[m_sparse[entityID]] = std::move(component);
+        }
+
+        m_sparse[entityID] = static_cast<uint32_t>(m_dense.size());
+        m_entities.push_back(entityID);
+        m_versions.push_back(0);
+        return m_dense.push_back(std::move(component));
+    }
+
+    /// @brief drop entityID's component, if it has one, by moving the last packed component into its place
+    void remove(EntityID entityID)
+    {
+        const uint32_t index = m_sparse[entityID];
+        if (index == npos)
+        {
+            return;
+        }
+
+        if (index != m_dense.size() - 1)
+        {
+            m_dense[index] = std::move(m_dense.back());
+            m_versions[index] = m_versions.back();
+            m_entities[index] = m_entities.back();
+            m_sparse[m_entities[index]] = index;
+        }
+        m_dense.pop_back();
+        m_versions.pop_back();
+        m_entities.pop_back();
+        m_sparse[entityID] = npos;
+    }
+
+    /// @brief record that entityID's component was written on tick, entityID must have one
+    void touch(EntityID entityID, uint32_t tick)
+    {
+        assert(has(entityID));
+        m_versions[m_sparse[entityID]] = tick;
+    }
+
+    uint32_t getVersion(EntityID entityID) const
+    {
+        assert(has(entityID));
+        return m_versions[m_sparse[entityID]];
+    }
+
+    /// @brief IDs of the entities that have the component, m_entities[i] owns getComponents()[i]
+    const std::vector<EntityID>& getEntities() const
+    {
+        return m_entities;
+    }
+
+    PagedVector<T>& getComponents()
+    {
+        return m_dense;
+    }
+
+private:
+
+    std::vector<uint32_t> m_sparse; // indexed by entity ID, npos if the entity doesn't have the component
+    PagedVector<T> m_dense;
+    PagedVector<uint32_t> m_versions; // version of each packed component
+    std::vector<EntityID> m_entities; // owner of each packed component
+};
+
+/// @brief the storage used for component T, picked by the isSparseComponent trait in Components.hpp
+template <typename T>
+using ComponentStorage = std::conditional_t<isSparseComponent<T>, SparseStorage<T>, DenseStorage<T>>;
@@ -0,0 +1,135 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Core
+#include "ComponentStorage.hpp"
+
+// Global
+#include "EntityBase.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+
+/// @brief the entities that have every component in Cs, with the component storages resolved once when the view is made
+/// @note callbacks get references straight into the storages, so a loop over a view never goes through the entity world
+/// callbacks may destroy entities but must not add or remove any of Cs while the view is iterating
+/// components in Cs that aren't const get touched on every visit, so list the ones a loop only reads as const (e.g. view<CTransform, const CBoundingBox>)
+template <typename... Cs>
+class ComponentView
+{
+    template <typename C>
+    using Storage = ComponentStorage<std::remove_const_t<C>>;
+
+public:
+
+    ComponentView(const std::vector<bool>& active, uint32_t tick, Storage<Cs>&... storages)
+        : m_active(active)
+        , m_tick(tick)
+        , m_storages(storages...)
+    { }
+
+    /// @brief call f(EntityID, Cs&...) for every active entity that has all of Cs
+    /// @note if any of Cs is sparse, only the entities of the smallest sparse storage are visited, otherwise every entity slot is
+    template <typename F>
+    void each(F&& f)
+    {
+        sweep(f, [](EntityID) { return true; });
+    }
+
+    /// @brief like each, but only for the entities whose T was added or accessed mutably after tick, T must be one of Cs
+    /// @note T's version is checked before the visit touches it, so T may be listed non-const, for catching up a consumer (e.g. a replicator or a lazy system) that last ran on tick
+    template <typename T, typename F>
+    void eachChangedSince(uint32_t tick, F&& f)
+    {
+        static_assert((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Cs>> || ...), "T must be one of the view's components");
+        sweep(f, [this, tick](EntityID id) { return std::get<Storage<T>&>(m_storages).getVersion(id) > tick; });
+    }
+
+    /// @brief call f(entity, Cs&...) for every active entity in entities (e.g. an EntityManager type list) that has all of Cs, in list order
+    /// @note each lookup goes through the storages by ID, so prefer each(f) unless the loop needs the list's entities or order
+    template <typename EntityList, typename F>
+    void each(EntityList& entities, F&& f)
+    {
+        for (auto& entity : entities)
+        {
+            const EntityID id = entity.getID();
+            if (m_active[id] && hasAll(id))
+            {
+                f(entity, access<Cs>(id)...);
+            }
+        }
+    }
+
+private:
+
+    const std::vector<bool>& m_active;
+    uint32_t m_tick; // world tick to stamp on mutably accessed components
+    std::tuple<Storage<Cs>&...> m_storages;
+
+    /// @brief call f(EntityID, Cs&...) for every active entity that has all of Cs and passes filter(EntityID)
+    template <typename F, typename Filter>
+    void sweep(F& f, Filter&& filter)
+    {
+        if constexpr ((isSparseComponent<std::remove_const_t<Cs>> || ...))
+        {
+            const std::vector<EntityID>& entities = smallestSparse();
+            for (size_t i = 0; i < entities.size(); ++i)
+            {
+                const EntityID id = entities[i];
+                if (m_active[id] && hasAll(id) && filter(id))
+                {
+                    f(id, access<Cs>(id)...);
+                }
+            }
+        }
+        else
+        {
+            for (EntityID id = 0; id < m_active.size(); ++id)
+            {
+                if (m_active[id] && hasAll(id) && filter(id))
+                {
+                    f(id, access<Cs>(id)...);
+                }
+            }
+        }
+    }
+
+    bool hasAll(EntityID id) const
+    {
+        return (std::get<Storage<Cs>&>(m_storages).has(id) && ...);
+    }
+
+    template <typename C>
+    C& access(EntityID id)
+    {
+        Storage<C>& storage = std::get<Storage<C>&>(m_storages);
+        if constexpr (!std::is_const_v<C>)
+        {
+            storage.touch(id, m_tick);
+        }
+        return storage.get(id);
+    }
+
+    /// @brief owner list of the sparse storage in Cs with the fewest components
+    const std::vector<EntityID>& smallestSparse() const
+    {
+        const std::vector<EntityID>* smallest = nullptr;
+        ([&]
+        {
+            if constexpr (isSparseComponent<std::remove_const_t<Cs>>)
+            {
+                const std::vector<EntityID>& entities = std::get<Storage<Cs>&>(m_storages).getEntities();
+                if (!smallest || entities.size() < smallest->size())
+                {
+                    smallest = &entities;
+                }
+            }
+        }(), ...);
+        return *smallest;
+    }
+};
@@ -29,7 +29,7 @@ CHealth::CHealth(int m, int c) : max(m), current(c) { }
 CBoundingBox::CBoundingBox(const Vec2f& s) : size(s), halfSize(s.x / 2, s.y / 2) { }
 CBoundingBox::CBoundingBox(const Vec2f& s, bool m, bool v) : size(s), halfSize(s.x / 2.0f, s.y / 2.0f), blockMove(m), blockVision(v) { }
 
-CAnimation::CAnimation(const Animation& animation, bool r) : animation(animation), repeat(r) { }
+CAnimation::CAnimation(AnimationID a, bool r) : id(a), repeat(r) { }
 
 CGravity::CGravity(float g) : gravity(g) { }
 
@@ -37,8 +37,13 @@ CState::CState(State s) : state(s) { }
 
 CFire::CFire(int fr, float minAcc, float maxAcc) : fireRate(fr), minAccuracy(minAcc), accuracy(maxAcc), maxAccuracy(maxAcc) { }
 
-CJointRelation::CJointRelation(const Entity& e, float minA, float maxA) : entityID(e.getID()), minAngle(minA), maxAngle(maxA) { }
+CJointRelation::CJointRelation(const Entity& e, float minA, float maxA) : entity(e.getHandle()), minAngle(minA), maxAngle(maxA) { }
+
+CJointRelation::CJointRelation(const EntityHandle& e, float minA, float maxA) : entity(e), minAngle(minA), maxAngle(maxA) { }
 
 CJointInfo::CJointInfo(const std::array<float, 3>& positions) : initJointOffsets(positions) { }
 
-CSkelAnim::CSkelAnim(const std::vector<SkelAnim>& skelAnims) : skelAnims(skelAnims) { }
+CSkelAnim::CSkelAnim()
+{
+    skelAnims.fill(none);
+}
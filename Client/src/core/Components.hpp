@@ -21,6 +21,7 @@
 // C++ standard libraries
 #include <string>
 #include <array>
+#include <limits>
 #include <chrono>
 
 class Entity;
@@ -31,6 +32,11 @@ public:
     bool exists = false;
 };
 
+/// @brief storage policy of component T in the memory pool, true packs it in a SparseStorage (see ComponentStorage.hpp)
+/// @note specialize to true for components few entities have, everything else gets a slot per entity
+template <typename T>
+inline constexpr bool isSparseComponent = false;
+
 /// NOTE: no const qualifiers for any members since components will be reused when a new entity is created in place of an inactive but previously active one
 
 /// TODO: consider dividing this into mult components for memory efficiency if needed
@@ -134,14 +140,17 @@ public:
     CBoundingBox(const Vec2f& s, bool m, bool v);
 };
 
+/// @brief which shared animation in Assets an entity plays and how far into it it is
 class CAnimation : public Component
 {
 public:
-    Animation animation;
+    AnimationID id = 0;
+    int frame = 0; // current animation frame
+    int gameFramesPassed = 0; // game frames since the animation started
     bool repeat = false; // looping animation
 
     CAnimation() = default;
-    CAnimation(const Animation& animation, bool r);
+    CAnimation(AnimationID a, bool r);
 };
 
 class CGravity : public Component
@@ -186,11 +195,12 @@ public:
 class CJointRelation : public Component
 {
 public:
-    EntityID entityID; // cannot use pointer to entity, must then change the way add entity returns copies, and entity map stores copies; cannot use entity cuz of circular dependency; cannot use entity reference because cannot be default initialized
+    EntityHandle entity; // cannot use pointer to entity, must then change the way add entity returns copies, and entity map stores copies; cannot use entity cuz of circular dependency; cannot use entity reference because cannot be default initialized
     float minAngle, maxAngle; // angles defined for when player dies facing right
 
     CJointRelation() = default;
     CJointRelation(const Entity& e, float minA, float maxA);
+    CJointRelation(const EntityHandle& e, float minA, float maxA);
 };
 
 class CJointInfo : public Component
@@ -202,16 +212,30 @@ public:
     CJointInfo(const std::array<float, 3>& positions);
 };
 
-/// @brief holds a vector of SkelAnim objects, uses CState to determine which one to use
+/// @brief the shared skeletal animation (in Assets) to play for each CState, plus this entity's current pose
 class CSkelAnim : public Component
 {
 public:
-    std::vector<SkelAnim> skelAnims; // skeletal animations for each CState
+    static constexpr SkelAnimID none = std::numeric_limits<SkelAnimID>::max(); // no animation for a state
+
+    std::array<SkelAnimID, static_cast<size_t>(State::NUM_STATES)> skelAnims; // skeletal animation for each CState
+    Skeleton currentFrame; // pose sampled from the current animation
+    size_t lastKeyFrameIdx = 0;
+    float timeSinceLastKeyFrame = 0.0f; // seconds
 
-    CSkelAnim() = default;
-    CSkelAnim(const std::vector<SkelAnim>& skelAnims);
+    CSkelAnim();
 };
 
+// components only players, weapons, and ragdoll parts have
+template <>
+inline constexpr bool isSparseComponent<CInput> = true;
+template <>
+inline constexpr bool isSparseComponent<CFire> = true;
+template <>
+inline constexpr bool isSparseComponent<CJointInfo> = true;
+template <>
+inline constexpr bool isSparseComponent<CSkelAnim> = true;
+
 // class CFollowPlayer : public Component
 // {
 // public:
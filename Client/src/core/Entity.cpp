@@ -2,7 +2,7 @@
 
 // Core
 #include "Entity.hpp"
-#include "EntityMemoryPool.hpp"
+#include "EntityWorld.hpp"
 
 // C++ standard libraries
 #include <string>
@@ -10,21 +10,30 @@
 /// TODO: consider adding subtypes of entities like Tiles so that entity ids (check EntityMemoryPool) don't have to be offset for different memory pools (requires taking entityID - maxTiles as index to memory pool after tile memory pool)
 
 /// TODO: is this bad? need a new way of doing this so that Entity constructor stays private, maybe create new files for tile management and new classes inheriting from entity like Tile with a private constructor in the same file as the tile matrix functions
-Entity::Entity(EntityID id) : m_id(id) { }
+Entity::Entity(EntityID id, uint32_t generation, EntityWorld* world) : m_id(id), m_generation(generation), m_world(world) { }
 
-/// @brief destroy this entity
+/// @brief destroy this entity, does nothing if it was already destroyed (even if its slot now holds another entity)
 void Entity::destroy() const
 {
-    EntityMemoryPool::Instance().removeEntity(m_id);
+    if (m_world)
+    {
+        m_world->removeEntity(m_id, m_generation);
+    }
 }
 
-/// @brief get a bool representing this entities living status
+/// @brief get a bool representing this entities living status, false once destroyed even if its slot was reused
 bool Entity::isActive() const
 {
-    return EntityMemoryPool::Instance().isActive(m_id);
+    return m_world && m_world->isAlive(m_id, m_generation);
 }
 
 EntityID Entity::getID() const
 {
     return m_id;
 }
+
+/// @brief the ID and generation of this entity, for storing it where an Entity can't be
+EntityHandle Entity::getHandle() const
+{
+    return { m_id, m_generation };
+}
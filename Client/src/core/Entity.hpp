@@ -3,7 +3,7 @@
 #pragma once
 
 // Core
-#include "EntityMemoryPool.hpp"
+#include "EntityWorld.hpp"
 
 // Utility
 #include "utility/ClientGlobals.hpp"
@@ -17,8 +17,9 @@
 class Entity : public EntityBase
 {
     EntityID m_id = 0; // defaults to 0, don't use 0 as a valid entity
-    Entity(EntityID id);
-    friend class EntityMemoryPool;
+    uint32_t m_generation = 0; // generation of slot m_id when this entity was made, 0 is never alive
+    EntityWorld* m_world = nullptr; // the world whose pool holds this entity's components
+    Entity(EntityID id, uint32_t generation, EntityWorld* world);
     friend class EntityManager; // so let entity manager create entities from entity IDs
 
 public:
@@ -31,7 +32,21 @@ public:
     {
         // PROFILE_FUNCTION();
 
-        return EntityMemoryPool::Instance().getComponent<T>(m_id);
+        return m_world->getComponent<T>(m_id);
+    }
+
+    /// @brief get a component of type T from this entity without marking it changed, for code that only reads it
+    template <typename T>
+    const T& readComponent() const
+    {
+        return m_world->readComponent<T>(m_id);
+    }
+
+    /// @brief whether this entity's component of type T was added or accessed through getComponent after tick, it must have one
+    template <typename T>
+    bool hasChangedSince(uint32_t tick) const
+    {
+        return m_world->hasChangedSince<T>(m_id, tick);
     }
 
     /// @brief check to see if this entity has a component of type T
@@ -40,7 +55,7 @@ public:
     {
         // PROFILE_FUNCTION();
 
-        return EntityMemoryPool::Instance().hasComponent<T>(m_id);
+        return m_world->hasComponent<T>(m_id);
     }
 
     /// @brief add a component of type T with argument mArgs of types TArgs to this entity
@@ -49,10 +64,18 @@ public:
     {
         // PROFILE_FUNCTION();
 
-        return EntityMemoryPool::Instance().addComponent<T>(m_id, std::forward<TArgs>(mArgs)...);
+        return m_world->addComponent<T>(m_id, std::forward<TArgs>(mArgs)...);
+    }
+
+    /// @brief remove this entity's component of type T, if it has one
+    template <typename T>
+    void removeComponent()
+    {
+        m_world->removeComponent<T>(m_id);
     }
 
     void destroy() const;
     bool isActive() const;
     EntityID getID() const;
+    EntityHandle getHandle() const;
 };
@@ -4,7 +4,8 @@
 
 // Core
 #include "Entity.hpp"
-#include "EntityMemoryPool.hpp"
+#include "EntityWorld.hpp"
+#include "CommandBuffer.hpp"
 
 // Global
 #include "Timer.hpp"
@@ -12,48 +13,114 @@
 // C++ standard libraries
 #include <string>
 #include <vector>
+#include <array>
+#include <limits>
+#include <cstdint>
 
 class EntityManager
 {
+    /// @brief where an entity sits in m_entityVecArr
+    struct ListSlot
+    {
+        Entity::Type type = Entity::Type::NUM_TYPES;
+        uint32_t index = npos; // npos if the entity isn't in a list
+    };
+
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    EntityWorld& m_world;
     std::vector<std::pair<Entity::Type, Entity>> m_entitiesToAdd;
     std::array<std::vector<Entity>, Entity::Type::NUM_TYPES> m_entityVecArr; // collidable layer entities without a dedicated layer matrix (player, bullet, weapon, npc, etc.), NO TILES
+    std::vector<ListSlot> m_listSlots; // indexed by entity ID
+    std::vector<CommandBuffer> m_commandBuffers = std::vector<CommandBuffer>(1); // one per worker, [0] for the main thread
 
-    /// @brief remove dead entities from param entities
+    /// @brief remove the entities destroyed since the last update from their lists, swapping each list's last entity into the hole
+    /// @note order within a type list isn't kept
     void removeDeadEntities()
     {
         PROFILE_FUNCTION();
 
-        // remove from m_liveEntities
-        // auto it = std::remove_if(m_liveEntities.begin(), m_liveEntities.end(),
-        //     [](const Entity& entity) { return !entity.isActive(); });
-        // m_liveEntities.erase(it, m_liveEntities.end());
-
-        // remove from m_entityVecArr
-        /// TODO: super slow if m_entityVecArr becomes large
-        /// TODO: try the locational thing to the player like the tileMatrix[x][y]? try pre initialized vectors and just use active vs inactive? remove map entirely in favor of different memory pools or something for each type of entity?
-        for (std::vector<Entity>& entityVec : m_entityVecArr)
+        for (const EntityID id : m_world.getDestroyed())
         {
-            auto itMap = std::remove_if(entityVec.begin(), entityVec.end(), [](const Entity& entity) { return !entity.isActive(); });
-            entityVec.erase(itMap, entityVec.end());
+            if (id >= m_listSlots.size() || m_listSlots[id].index == npos) // destroyed before it was added, or already removed (its slot was reused and released again)
+            {
+                continue;
+            }
+
+            ListSlot& slot = m_listSlots[id];
+
+            std::vector<Entity>& entityVec = m_entityVecArr[slot.type];
+            if (slot.index != entityVec.size() - 1)
+            {
+                entityVec[slot.index] = entityVec.back();
+                m_listSlots[entityVec[slot.index].getID()].index = slot.index;
+            }
+            entityVec.pop_back();
+            slot.index = npos;
         }
+        m_world.clearDestroyed();
     }
 
 public:
-    EntityManager() = default;
-
-    /// TODO: implement new version of this if needed
-    /// @brief adds entities to be added and removes entities to be destroyed
+    /// @param world the world the managed entities live in, must outlive the manager
+    explicit EntityManager(EntityWorld& world)
+        : m_world(world)
+    { }
+
+    /// @brief the sync point, plays back every command buffer, then removes entities destroyed and adds entities staged since the last update, doing nothing if none of that happened
+    /// @note buffers are played back in worker order, so the result doesn't depend on how threads were scheduled
+    /// removals go first, so an entity destroyed in a slot that was then reused is taken out before the new one goes in
     void update()
     {
         PROFILE_FUNCTION();
 
+        for (CommandBuffer& commands : m_commandBuffers)
+        {
+            if (!commands.empty())
+            {
+                commands.playback(*this);
+            }
+        }
+
+        if (m_entitiesToAdd.empty() && m_world.getDestroyed().empty())
+        {
+            return;
+        }
+
+        removeDeadEntities();
+
         for (std::pair<Entity::Type, Entity>& pair : m_entitiesToAdd)
         {
-            m_entityVecArr[pair.first].push_back(pair.second);
+            const Entity& entity = pair.second;
+            if (!entity.isActive()) // destroyed the frame it was made
+            {
+                continue;
+            }
+
+            std::vector<Entity>& entityVec = m_entityVecArr[pair.first];
+            if (entity.getID() >= m_listSlots.size())
+            {
+                m_listSlots.resize(entity.getID() + 1);
+            }
+            m_listSlots[entity.getID()] = { pair.first, static_cast<uint32_t>(entityVec.size()) };
+            entityVec.push_back(entity);
         }
         m_entitiesToAdd.clear();
+    }
 
-        removeDeadEntities();
+    /// @brief the command buffer for worker to record structural changes into while systems run, applied at the next update
+    /// @note each worker thread must record only into its own buffer, the main thread uses worker 0
+    CommandBuffer& getCommandBuffer(size_t worker = 0)
+    {
+        assert(worker < m_commandBuffers.size());
+        return m_commandBuffers[worker];
+    }
+
+    /// @brief make one command buffer per worker thread, call only while no system is recording
+    void setWorkerCount(size_t workers)
+    {
+        assert(workers > 0);
+        m_commandBuffers.resize(workers);
     }
 
     /// @brief marks new Entity to be added on next call to EntityManager::update, returns new Entity
@@ -61,7 +128,8 @@ public:
     {
         // PROFILE_FUNCTION();
 
-        Entity e = EntityMemoryPool::Instance().addEntity();
+        const EntityID id = m_world.addEntity();
+        Entity e(id, m_world.getGeneration(id), &m_world);
         m_entitiesToAdd.emplace_back(type, e);
         return e;
     }
@@ -76,10 +144,24 @@ public:
         return m_entityVecArr[type];
     }
 
+    /// @brief a view over the entities with every component in Cs, the storages are looked up once here instead of on every getComponent call
+    template <typename... Cs>
+    auto view()
+    {
+        return m_world.view<Cs...>();
+    }
+
     /// @brief get a single entity from its ID, for use only when entity ID must be used over entity, only use when attempting to access components of a known, existing entity with entityID id
+    /// @note the entity gets the slot's current generation, so this is whatever entity lives in slot id now, use a handle to refer to one specific entity
     Entity getEntity(EntityID id) const
     {
-        return Entity(id);
+        return Entity(id, m_world.getGeneration(id), &m_world);
+    }
+
+    /// @brief the entity handle was made from, which isn't active if it has been destroyed since
+    Entity getEntity(const EntityHandle& handle) const
+    {
+        return Entity(handle.id, handle.generation, &m_world);
     }
 
     /// TODO: implement the new version of this if needed
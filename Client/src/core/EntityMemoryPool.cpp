@@ -15,31 +15,9 @@
 
 /// @brief construct the entity memory pools (under one EntityMemoryPool object) and associated member variables
 EntityMemoryPool::EntityMemoryPool(EntityID maxEntities)
-    : m_maxEntities(maxEntities),
-    m_active(std::vector<bool>(maxEntities))
+    : m_slots(0)
 {
-
-    for (EntityID i = 0; i < maxEntities; ++i)
-    {
-        m_entityFreeList.push(i);
-    }
-
-    m_pool = std::make_tuple(
-        std::vector<CAnimation>(maxEntities),
-        std::vector<CTransform>(maxEntities),
-        std::vector<CBoundingBox>(maxEntities),
-        std::vector<CHealth>(maxEntities),
-        std::vector<CLifespan>(maxEntities),
-        std::vector<CDamage>(maxEntities),
-        std::vector<CInvincibility>(maxEntities),
-        std::vector<CInput>(maxEntities),
-        std::vector<CGravity>(maxEntities),
-        std::vector<CState>(maxEntities),
-        std::vector<CFire>(maxEntities),
-        std::vector<CJointRelation>(maxEntities),
-        std::vector<CJointInfo>(maxEntities),
-        std::vector<CSkelAnim>(maxEntities)
-    );
+    reserve(maxEntities);
 
     // m_pool = std::make_tuple(
     //     std::vector<CTransform>(maxEntities),
@@ -68,55 +46,52 @@ EntityMemoryPool::EntityMemoryPool(EntityID maxEntities)
     //     }, m_pool);
 // }
 
-/// @brief singleton class for entity memory pool
-/// @return same, persistent instance of the class
-EntityMemoryPool& EntityMemoryPool::Instance()
+EntityID EntityMemoryPool::addEntity()
 {
-    static EntityMemoryPool pool(Settings::worldMaxEntities);
-    // static EntityMemoryPool pool(Settings::worldMaxCells.x * Settings::worldMaxCells.y, Settings::worldMaxEntities);
-    return pool;
-} // a singleton, globally acces in safe way, only one instance ever
+    // find index, growing by a page if every slot is taken
+    if (m_slots.isFull())
+    {
+        reserve(m_slots.getCapacity() + EntitySlots::pageSize);
+    }
+    const EntityID index = m_slots.allocate();
 
-/// TODO: could consider just returning IDs everywhere instead of entity objects
+    // drop whatever the previous entity at index had, dense storages just clear the exists flag instead of default constructing values
+    std::apply([index](auto &...storages)
+        {
+            ((storages.remove(index)), ...);
+        }, m_pool);
 
-Entity EntityMemoryPool::addEntity()
-{
-    EntityID index;
+    return index;
+}
 
-    // find index
-    if (!m_entityFreeList.empty())
-    {
-        index = m_entityFreeList.front();
-        m_entityFreeList.pop();
-    }
-    else
+void EntityMemoryPool::reserve(EntityID capacity)
+{
+    if (capacity <= m_slots.getCapacity())
     {
-        std::cerr << "Other entities memory pool full" << std::endl;
-        exit(-1);
+        return;
     }
 
-    // just set exists flag to false at index, no need to create default constructed values
-    std::apply([index](auto &...args)
+    // dense storages get a slot per entity, sparse ones only size their index table
+    std::apply([capacity](auto &...storages)
         {
-            ((args[index].exists = false), ...);  // reset "exists" flag for each component
+            ((storages.resize(capacity)), ...);
         }, m_pool);
-
-    // set active status
-    m_active[index] = true;
-
-    return Entity(index);
+    m_slots.grow(capacity);
 }
 
 /// @brief remove an entity from its pool
-void EntityMemoryPool::removeEntity(EntityID entityID)
+void EntityMemoryPool::removeEntity(EntityID entityID, uint32_t generation)
 {
-    m_active[entityID] = false;
-
-    m_entityFreeList.push(entityID);
+    m_slots.release(entityID, generation);
 }
 
 /// @brief check to see if an entity is active
-bool EntityMemoryPool::isActive(EntityID entityID)
+bool EntityMemoryPool::isAlive(EntityID entityID, uint32_t generation) const
+{
+    return m_slots.isAlive(entityID, generation);
+}
+
+uint32_t EntityMemoryPool::getGeneration(EntityID entityID) const
 {
-    return m_active[entityID];
+    return m_slots.getGeneration(entityID);
 }
@@ -11,6 +11,9 @@
 
 // Core
 #include "Components.hpp"
+#include "ComponentStorage.hpp"
+#include "ComponentView.hpp"
+#include "EntitySlots.hpp"
 
 // Utility
 #include "utility/ClientGlobals.hpp"
@@ -18,8 +21,9 @@
 // C++ standard libraries
 #include <vector>
 #include <string>
-#include <queue>
 #include <iostream>
+#include <type_traits>
+#include <cstdint>
 // #include <unordered_map>
 
 /// container typename method
@@ -54,8 +58,6 @@
 // template <typename T>
 // using ContainerType = typename ComponentContainer<T>::Type;
 
-class Entity; // forward declaration
-
 // |      |  E0  |  E1  |  E2  |  E3  |  E4  |  E5  |  E6  |  E7  |  E8  |
 // |------| ---- | ---- | ---- | ---- | ---- | ---- | ---- | ---- | ---- |
 // |  C1  | 0, F | 0, F | 0, F | 0, F | 0, F | 0, F | 0, F | 0, F | 0, F |
@@ -66,10 +68,10 @@ class Entity; // forward declaration
 
 class EntityMemoryPool
 {
-    EntityID m_maxEntities;
 
     // std::queue<EntityID> m_tileFreeList; // stores indices of inactive tiles to accelerate searching
-    std::queue<EntityID> m_entityFreeList; // stores indices of inactive entities to accelerate searching
+    EntitySlots m_slots; // generations, active flags, and the free list
+    uint32_t m_tick = 1; // stamped on components as they're written, 0 means never written
 
     // using vectors for frequently needed components and unordered maps for sparse ones
     // tuple stored on stack, vector istelf on stack but elements they hold allocated dynamically on heap
@@ -99,31 +101,28 @@ class EntityMemoryPool
     //     // std::vector<CGravity> /// TODO: will need this if tiles are falling, and will have to add back CTransform or new CVelocity and CRotation stuff
     // > m_tilePool;
 
-    // all entities but tiles (layer 0) and decorations (layer 1) /// TODO: maybe use unordered_map here instead of vectors if entities are hella spread out component-wise and there are lots of them, wasting memory
+    // all entities but tiles (layer 0) and decorations (layer 1), dense or sparse per component through isSparseComponent
     std::tuple<
-        std::vector<CAnimation>,
-        std::vector<CTransform>,
-        std::vector<CBoundingBox>,
-        std::vector<CHealth>,
-        std::vector<CLifespan>,
-        std::vector<CDamage>,
-        std::vector<CInvincibility>, // brief moment after taking damage
-        std::vector<CInput>, // for player only (for now...)
-        std::vector<CGravity>,
-        std::vector<CState>, // "air", "stand", "run"
-        std::vector<CFire>,
-        std::vector<CJointRelation>,
-        std::vector<CJointInfo>,
-        std::vector<CSkelAnim>
+        ComponentStorage<CAnimation>,
+        ComponentStorage<CTransform>,
+        ComponentStorage<CBoundingBox>,
+        ComponentStorage<CHealth>,
+        ComponentStorage<CLifespan>,
+        ComponentStorage<CDamage>,
+        ComponentStorage<CInvincibility>, // brief moment after taking damage
+        ComponentStorage<CInput>, // for player only (for now...)
+        ComponentStorage<CGravity>,
+        ComponentStorage<CState>, // "air", "stand", "run"
+        ComponentStorage<CFire>,
+        ComponentStorage<CJointRelation>,
+        ComponentStorage<CJointInfo>,
+        ComponentStorage<CSkelAnim>
         // std::vector<CFollowPlayer>, // NPC behavior
         // std::vector<CPatrol> // NPC behavior
     > m_pool;
 
-    std::vector<bool> m_active;
-
     // decorations (layer 1) /// TODO: think of where to include these or if use new memory pool
 
-    EntityMemoryPool(EntityID maxEntities);
     // EntityMemoryPool(EntityID maxTiles, EntityID maxEntities);
 
     // void resetEntityAtIndex(EntityID index);
@@ -173,16 +172,23 @@ class EntityMemoryPool
     // }
 
 public:
-    static EntityMemoryPool& Instance();
+    /// @param maxEntities initial capacity, the pool grows a page at a time past it
+    explicit EntityMemoryPool(EntityID maxEntities);
+
+    // one pool per world, entities point at it, so it can't be copied or moved out from under them
+    EntityMemoryPool(const EntityMemoryPool&) = delete;
+    EntityMemoryPool& operator=(const EntityMemoryPool&) = delete;
 
-    /// @brief returns a component of type T from an entity with ID entityID
+    /// @brief returns a component of type T from an entity with ID entityID, marking it changed on the current tick since the caller can write it
     /// TODO: may be better way to separate tiles and other entities than doing this if else (same for methods below)
     template <typename T>
     T& getComponent(EntityID entityID)
     {
         // if constexpr (!isTileComponent<T>())
         // {
-        return std::get<std::vector<T>>(m_pool)[entityID];
+        ComponentStorage<T>& storage = std::get<ComponentStorage<T>>(m_pool);
+        storage.touch(entityID, m_tick);
+        return storage.get(entityID);
         // return std::get<std::vector<T>>(m_otherEntityPool)[entityID - m_maxTiles];
     // }
     // else
@@ -212,17 +218,39 @@ public:
     // return container[entityID];
     }
 
+    /// @brief returns a component of type T from an entity with ID entityID without marking it changed
+    template <typename T>
+    const T& readComponent(EntityID entityID)
+    {
+        return std::get<ComponentStorage<T>>(m_pool).get(entityID);
+    }
+
+    /// @brief whether entityID's component of type T was added or accessed mutably after tick, it must have one
+    template <typename T>
+    bool hasChangedSince(EntityID entityID, uint32_t tick) const
+    {
+        return std::get<ComponentStorage<T>>(m_pool).getVersion(entityID) > tick;
+    }
+
+    /// @brief the tick component writes are stamped with now
+    uint32_t getTick() const
+    {
+        return m_tick;
+    }
+
+    /// @brief start a new tick, call once per simulation step before any system runs
+    void advanceTick()
+    {
+        ++m_tick;
+    }
+
     /// @brief check to see if entity entityID has a component of type T
-    /// TODO: implement this
     template <typename T>
     bool hasComponent(EntityID entityID)
     {
         // if constexpr (!isTileComponent<T>())
         // {
-        std::vector<T>& componentVector = std::get<std::vector<T>>(m_pool);
-        T& component = componentVector[entityID];
-        // T& component = componentVector[entityID - m_maxTiles];
-        return component.exists;
+        return std::get<ComponentStorage<T>>(m_pool).has(entityID);
         // }
         // else
         // {
@@ -268,11 +296,9 @@ public:
         // std::cout << "adding component to entity " << entityID << std::endl;
         // if constexpr (!isTileComponent<T>()) // not a tile component
         // {
-        std::vector<T>& componentVector = std::get<std::vector<T>>(m_pool);
-        T& component = componentVector[entityID];
-        // T& component = componentVector[entityID - m_maxTiles];
-        component = T(std::forward<TArgs>(mArgs)...);
-        component.exists = true;
+        ComponentStorage<T>& storage = std::get<ComponentStorage<T>>(m_pool);
+        T& component = storage.add(entityID, T(std::forward<TArgs>(mArgs)...));
+        storage.touch(entityID, m_tick);
         return component;
         // }
         // else // could be tile or other entity
@@ -324,12 +350,61 @@ public:
         // return container[entityID];
     }
 
-    /// @brief add an entity
-    Entity addEntity();
+    /// @brief remove entityID's component of type T, if it has one
+    template <typename T>
+    void removeComponent(EntityID entityID)
+    {
+        std::get<ComponentStorage<T>>(m_pool).remove(entityID);
+    }
+
+    /// @brief the storage of every component of type T, a SparseStorage can be iterated without touching entities that don't have T
+    template <typename T>
+    ComponentStorage<T>& getStorage()
+    {
+        return std::get<ComponentStorage<T>>(m_pool);
+    }
+
+    /// @brief the active entities that have every component in Cs, see ComponentView
+    template <typename... Cs>
+    ComponentView<Cs...> view()
+    {
+        return ComponentView<Cs...>(m_slots.getActive(), m_tick, getStorage<std::remove_const_t<Cs>>()...);
+    }
 
-    /// @brief remove an entity from the memory pool
-    void removeEntity(EntityID entityID);
+    /// @brief add an entity, wrap its ID and generation in an Entity to use it
+    EntityID addEntity();
 
-    /// @brief return a bool representing the entity's living status
-    bool isActive(EntityID entityID);
+    /// @brief remove an entity from the memory pool, unless generation says it was already removed
+    void removeEntity(EntityID entityID, uint32_t generation);
+
+    /// @brief return a bool representing the living status of the entity with this ID and generation
+    bool isAlive(EntityID entityID, uint32_t generation) const;
+
+    /// @brief the generation of whatever entity is (or was last) in slot entityID
+    uint32_t getGeneration(EntityID entityID) const;
+
+    /// @brief make room for at least capacity entities, existing components don't move
+    void reserve(EntityID capacity);
+
+    EntityID getCapacity() const
+    {
+        return m_slots.getCapacity();
+    }
+
+    /// @brief the most entities that have been alive at once, for sizing the initial capacity
+    EntityID getHighWaterMark() const
+    {
+        return m_slots.getHighWaterMark();
+    }
+
+    /// @brief IDs of the entities removed since the last clearDestroyed, so EntityManager only touches the entities that died
+    const std::vector<EntityID>& getDestroyed() const
+    {
+        return m_slots.getDestroyed();
+    }
+
+    void clearDestroyed()
+    {
+        m_slots.clearDestroyed();
+    }
 };
@@ -0,0 +1,173 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Core
+#include "PagedVector.hpp"
+
+// Global
+#include "EntityBase.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+/// @brief the entity slots of a memory pool, a generation and active flag per slot plus a free list threaded through the free slots themselves
+/// @note destroying an entity bumps its slot's generation, so every handle made before that stops matching and isAlive is one compare
+/// freed slots are reused oldest first, so a destroyed entity's components stay readable for a while after it's gone, which systems that destroy mid-loop rely on
+class EntitySlots
+{
+public:
+
+    static constexpr EntityID npos = std::numeric_limits<EntityID>::max();
+    static constexpr EntityID pageSize = static_cast<EntityID>(PagedVector<bool>::pageSize); // slots added each time a full pool grows, one page of every dense storage
+
+    explicit EntitySlots(EntityID maxEntities)
+    {
+        grow(maxEntities);
+    }
+
+    bool isFull() const
+    {
+        return m_freeHead == npos;
+    }
+
+    /// @brief add free slots up to capacity, after every slot already free
+    void grow(EntityID capacity)
+    {
+        const EntityID oldCapacity = getCapacity();
+        if (capacity <= oldCapacity)
+        {
+            return;
+        }
+
+        m_slots.resize(capacity);
+        m_active.resize(capacity);
+        for (EntityID i = oldCapacity; i < capacity; ++i)
+        {
+            m_slots[i].nextFree = i + 1 < capacity ? i + 1 : npos;
+        }
+
+        if (m_freeTail == npos)
+        {
+            m_freeHead = oldCapacity;
+        }
+        else
+        {
+            m_slots[m_freeTail].nextFree = oldCapacity;
+        }
+        m_freeTail = capacity - 1;
+    }
+
+    EntityID getCapacity() const
+    {
+        return static_cast<EntityID>(m_slots.size());
+    }
+
+    EntityID getLiveCount() const
+    {
+        return m_liveCount;
+    }
+
+    /// @brief the most entities that have been alive at once
+    EntityID getHighWaterMark() const
+    {
+        return m_highWaterMark;
+    }
+
+    /// @brief take the oldest free slot and mark it active, check isFull first
+    EntityID allocate()
+    {
+        const EntityID index = m_freeHead;
+        m_freeHead = m_slots[index].nextFree;
+        if (m_freeHead == npos)
+        {
+            m_freeTail = npos;
+        }
+
+        m_active[index] = true;
+        if (++m_liveCount > m_highWaterMark)
+        {
+            m_highWaterMark = m_liveCount;
+        }
+        return index;
+    }
+
+    /// @brief free the slot if generation is its current one, so destroying through a stale handle does nothing
+    /// @return whether the slot was freed
+    bool release(EntityID index, uint32_t generation)
+    {
+        if (!isAlive(index, generation))
+        {
+            return false;
+        }
+
+        m_active[index] = false;
+        ++m_slots[index].generation;
+        --m_liveCount;
+
+        // append to the tail of the free list
+        m_slots[index].nextFree = npos;
+        if (m_freeTail == npos)
+        {
+            m_freeHead = index;
+        }
+        else
+        {
+            m_slots[m_freeTail].nextFree = index;
+        }
+        m_freeTail = index;
+
+        m_destroyed.push_back(index);
+        return true;
+    }
+
+    bool isAlive(EntityID index, uint32_t generation) const
+    {
+        return index < m_slots.size() && m_active[index] && m_slots[index].generation == generation;
+    }
+
+    bool isActive(EntityID index) const
+    {
+        return m_active[index];
+    }
+
+    uint32_t getGeneration(EntityID index) const
+    {
+        return m_slots[index].generation;
+    }
+
+    /// @brief indexed by entity ID, for views to skip inactive slots
+    const std::vector<bool>& getActive() const
+    {
+        return m_active;
+    }
+
+    /// @brief slots released since the last clearDestroyed, in order, a slot reused and released again shows up twice
+    const std::vector<EntityID>& getDestroyed() const
+    {
+        return m_destroyed;
+    }
+
+    void clearDestroyed()
+    {
+        m_destroyed.clear();
+    }
+
+private:
+
+    struct Slot
+    {
+        uint32_t generation = 1; // 0 is never a live generation, so default handles are never alive
+        EntityID nextFree = npos; // only meaningful while the slot is free
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<bool> m_active;
+    EntityID m_freeHead = npos; // oldest free slot, reused first
+    EntityID m_freeTail = npos; // newest free slot
+    std::vector<EntityID> m_destroyed;
+    EntityID m_liveCount = 0;
+    EntityID m_highWaterMark = 0;
+};
@@ -0,0 +1,26 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+/// @brief the entities and components of one simulation, owned by the scene running it, entities point back to the world they belong to
+/// @note the storage backend is the per-component EntityMemoryPool by default or the ArchetypePool with ARCHETYPE_ENTITY_POOL defined
+/// both have the same getComponent, hasComponent, addComponent, view, addEntity, removeEntity, and isAlive, but adding or removing a component with the archetype pool moves the entity's components and the last entity in its old archetype, invalidating references to both
+/// worlds share no state, so separate worlds can simulate on separate threads, and nothing in one needs a window or renderer
+
+// #define ARCHETYPE_ENTITY_POOL
+
+#pragma once
+
+#ifdef ARCHETYPE_ENTITY_POOL
+
+// Core
+#include "ArchetypePool.hpp"
+
+using EntityWorld = ArchetypePool;
+
+#else
+
+// Core
+#include "EntityMemoryPool.hpp"
+
+using EntityWorld = EntityMemoryPool;
+
+#endif
@@ -87,6 +87,7 @@ void GameEngine::update()
     sUserInput();
     // currentScene()->updateState(lag, m_netManager.update());
     currentScene()->updateState();
+    m_netManager.flush(); // everything the scene sent this frame goes out as one packet
 }
 
 /// TODO: consider separate functions for keyboard, mouse, controller, touch, etc. to reduce size of this function
@@ -0,0 +1,176 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "world/TileManager.hpp"
+
+// External libraries
+#include <SFML/Graphics.hpp>
+
+// C++ standard libraries
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+/// @brief the whole world with one texel per cell, built once and patched from the TileManager edit log, so a map can be drawn as one sprite
+/// @note cells that block movement or vision get their tile color, everything else is transparent
+/// edits are collected into one dirty rectangle per 64x64 chunk, and each rectangle is a single texture update
+/// nothing here makes a chunk resident except reading the cells of logged edits, which were just written and are resident anyway
+class MinimapTexture
+{
+public:
+
+    static constexpr int chunkSize = TileManager::chunkSize;
+    static constexpr int chunkShift = TileManager::chunkShift;
+
+    MinimapTexture(int cellsX, int cellsY)
+        : m_cellsX(cellsX)
+        , m_cellsY(cellsY)
+    { }
+
+    /// @brief color every cell from scratch, call once the world is loaded
+    /// @note reads chunk by chunk through TileManager::copyChunkTypes, so evicted chunks are generated or read once and never made resident
+    void build(const TileManager& tiles)
+    {
+        const sf::Vector2u size { static_cast<unsigned int>(m_cellsX), static_cast<unsigned int>(m_cellsY) };
+        if (size.x > sf::Texture::getMaximumSize() || size.y > sf::Texture::getMaximumSize())
+        {
+            std::cerr << "World is too large for a minimap texture on this GPU\n";
+            exit(-1);
+        }
+
+        m_image.resize(size, sf::Color::Transparent);
+        for (int cy = 0; cy << chunkShift < m_cellsY; ++cy)
+        {
+            for (int cx = 0; cx << chunkShift < m_cellsX; ++cx)
+            {
+                colorChunk(tiles, cx, cy);
+            }
+        }
+
+        if (!m_texture.loadFromImage(m_image))
+        {
+            std::cerr << "Could not create the minimap texture\n";
+            exit(-1);
+        }
+        m_dirty.clear();
+        m_generation = tiles.getEditGeneration();
+    }
+
+    /// @brief re-color the cells edited since the last update and upload one sub-rectangle per chunk that had edits
+    /// @note if the edit log already dropped some of them, only the chunks edited since the world was loaded are re-colored, the rest still match the image, so build has to be called again after TileManager::loadWorld
+    void update(TileManager& tiles)
+    {
+        std::span<const TileEdit> edits;
+        if (tiles.getEditsSince(m_generation, edits))
+        {
+            for (const TileEdit& edit : edits)
+            {
+                const Vec2i& cell = edit.cell;
+                m_image.setPixel({ static_cast<unsigned int>(cell.x), static_cast<unsigned int>(cell.y) }, getTexel(tiles, tiles.getType(cell.x, cell.y), cell.x, cell.y));
+                markDirty(cell.x, cell.y);
+            }
+        }
+        else
+        {
+            for (int cy = 0; cy << chunkShift < m_cellsY; ++cy)
+            {
+                for (int cx = 0; cx << chunkShift < m_cellsX; ++cx)
+                {
+                    if (tiles.isChunkEdited(cx, cy))
+                    {
+                        colorChunk(tiles, cx, cy);
+                        markDirty(cx << chunkShift, cy << chunkShift);
+                        markDirty(std::min((cx + 1) << chunkShift, m_cellsX) - 1, std::min((cy + 1) << chunkShift, m_cellsY) - 1);
+                    }
+                }
+            }
+        }
+
+        const uint8_t* pixels = m_image.getPixelsPtr();
+        for (const DirtyRect& rect : m_dirty)
+        {
+            // rows of the rectangle aren't contiguous in the image, copy them out before uploading
+            const int width = rect.maxX - rect.minX + 1;
+            const int height = rect.maxY - rect.minY + 1;
+            m_staging.resize(static_cast<size_t>(width * height * 4));
+            for (int y = rect.minY; y <= rect.maxY; ++y)
+            {
+                const uint8_t* row = pixels + static_cast<size_t>((y * m_cellsX + rect.minX) * 4);
+                std::copy(row, row + width * 4, m_staging.begin() + (y - rect.minY) * width * 4);
+            }
+            m_texture.update(m_staging.data(), { static_cast<unsigned int>(width), static_cast<unsigned int>(height) },
+                { static_cast<unsigned int>(rect.minX), static_cast<unsigned int>(rect.minY) });
+        }
+        m_dirty.clear();
+        m_generation = tiles.getEditGeneration();
+    }
+
+    /// @brief texel (x, y) is cell (x, y), so a view in cell coordinates can draw it unscaled
+    const sf::Texture& getTexture() const
+    {
+        return m_texture;
+    }
+
+private:
+
+    struct DirtyRect
+    {
+        size_t chunk;
+        int minX, maxX, minY, maxY;
+    };
+
+    int m_cellsX;
+    int m_cellsY;
+    sf::Image m_image; // CPU copy of the texture, the source of every sub-rectangle upload
+    sf::Texture m_texture;
+    std::vector<DirtyRect> m_dirty; // one per chunk with edits this update, usually only a handful so lookups are linear
+    std::vector<uint8_t> m_staging;
+    std::vector<TileType> m_chunkTypes = std::vector<TileType>(static_cast<size_t>(chunkSize * chunkSize)); // one chunk's types while coloring it
+    uint64_t m_generation = 0; // tile edit generation the texture includes
+
+    static sf::Color getTexel(const TileManager& tiles, TileType type, int x, int y)
+    {
+        if (!tiles.blocksMovement(x, y) && !tiles.blocksVision(x, y))
+        {
+            return sf::Color::Transparent;
+        }
+
+        const TileColor color = TileManager::getColor(type, x, y);
+        return sf::Color(color.r, color.g, color.b);
+    }
+
+    /// @brief re-color every cell of chunk (cx, cy) in the image
+    void colorChunk(const TileManager& tiles, int cx, int cy)
+    {
+        tiles.copyChunkTypes(cx, cy, m_chunkTypes);
+        for (int y = cy << chunkShift; y < std::min((cy + 1) << chunkShift, m_cellsY); ++y)
+        {
+            for (int x = cx << chunkShift; x < std::min((cx + 1) << chunkShift, m_cellsX); ++x)
+            {
+                const TileType type = m_chunkTypes[static_cast<size_t>(((y - (cy << chunkShift)) << chunkShift) + (x - (cx << chunkShift)))];
+                m_image.setPixel({ static_cast<unsigned int>(x), static_cast<unsigned int>(y) }, getTexel(tiles, type, x, y));
+            }
+        }
+    }
+
+    void markDirty(int x, int y)
+    {
+        const size_t chunk = static_cast<size_t>((y >> chunkShift) * ((m_cellsX >> chunkShift) + 1) + (x >> chunkShift));
+        for (DirtyRect& rect : m_dirty)
+        {
+            if (rect.chunk == chunk)
+            {
+                rect.minX = std::min(rect.minX, x);
+                rect.maxX = std::max(rect.maxX, x);
+                rect.minY = std::min(rect.minY, y);
+                rect.maxY = std::max(rect.maxY, y);
+                return;
+            }
+        }
+        m_dirty.push_back({ chunk, x, x, y, y });
+    }
+};
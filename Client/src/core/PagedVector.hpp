@@ -0,0 +1,97 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// C++ standard libraries
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+/// @brief a vector made of fixed-size pages, growing allocates a new page and never moves the elements already stored
+/// @note references stay valid until their element is popped or overwritten, unlike std::vector where any growth can invalidate them all
+template <typename T, size_t PageShift = 10>
+class PagedVector
+{
+public:
+
+    static constexpr size_t pageSize = size_t { 1 } << PageShift;
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// @brief elements that fit in the pages allocated so far
+    size_t capacity() const
+    {
+        return m_pages.size() * pageSize;
+    }
+
+    /// @brief grow to n elements, new ones are default constructed, never shrinks
+    void resize(size_t n)
+    {
+        reserve(n);
+        if (n > m_size)
+        {
+            m_size = n;
+        }
+    }
+
+    void reserve(size_t n)
+    {
+        while (capacity() < n)
+        {
+            m_pages.push_back(std::make_unique<T[]>(pageSize));
+        }
+    }
+
+    T& operator[](size_t i)
+    {
+        assert(i < m_size);
+        return m_pages[i >> PageShift][i & (pageSize - 1)];
+    }
+
+    const T& operator[](size_t i) const
+    {
+        assert(i < m_size);
+        return m_pages[i >> PageShift][i & (pageSize - 1)];
+    }
+
+    T& back()
+    {
+        return (*this)[m_size - 1];
+    }
+
+    T& push_back(T&& value)
+    {
+        reserve(m_size + 1);
+        ++m_size;
+        return back() = std::move(value);
+    }
+
+    T& push_back(const T& value)
+    {
+        reserve(m_size + 1);
+        ++m_size;
+        return back() = value;
+    }
+
+    /// @brief drop the last element, it's reset to a default value so whatever it owned is freed now
+    void pop_back()
+    {
+        back() = T {};
+        --m_size;
+    }
+
+private:
+
+    std::vector<std::unique_ptr<T[]>> m_pages;
+    size_t m_size = 0;
+};
@@ -15,6 +15,11 @@
 #include "Components.hpp"
 #include "Animation.hpp"
 #include "Action.hpp"
+#include "TileChunkMeshes.hpp"
+#include "TileTexture.hpp"
+#include "MinimapTexture.hpp"
+#include "EntityMemoryPool.hpp"
+#include "ArchetypePool.hpp"
 
 // Physics
 #include "physics/Vec2.hpp"
@@ -24,12 +29,12 @@
 #include "character/SkelAnim.hpp"
 
 // World
-#include "world/WorldGenerator.hpp"
 #include "world/TileType.hpp"
 
 // Global
 #include "Random.hpp"
 #include "Timer.hpp"
+#include "NetworkBatch.hpp"
 
 // External libraries
 #include <SFML/Graphics.hpp>
@@ -41,8 +46,10 @@
 #include <array>
 #include <fstream>
 #include <chrono>
-#include <unordered_set>
 #include <algorithm>
+#include <span>
+#include <iostream>
+#include <cmath>
 
 /// @param gameEngine the game's main engine which handles scene switching and adding, and other top-level functions; required by Scene to set m_game
 ScenePlay::ScenePlay(GameEngine& gameEngine, int worldSeed) : Scene(gameEngine)
@@ -67,6 +74,11 @@ void ScenePlay::init()
     registerAction(static_cast<unsigned int>(sf::Keyboard::Key::P), "PAUSE");
     registerAction(static_cast<unsigned int>(sf::Keyboard::Key::Escape), "QUIT"); /// TODO: change to show HUD or menu or something without leaving the game
     registerAction(static_cast<unsigned int>(sf::Keyboard::Key::M), "TOGGLE_MAP");
+    registerAction(static_cast<unsigned int>(sf::Keyboard::Key::Tab), "TOGGLE_WORLD_MAP");
+    registerAction(static_cast<unsigned int>(sf::Keyboard::Key::B), "BENCHMARK_FLOOD_FILL");
+    registerAction(static_cast<unsigned int>(sf::Keyboard::Key::N), "BENCHMARK_ENTITY_POOLS");
+    registerAction(static_cast<unsigned int>(sf::Keyboard::Key::K), "BENCHMARK_NETWORK");
+    registerAction(static_cast<unsigned int>(sf::Keyboard::Key::T), "TOGGLE_TILE_RENDER");
     // player keyboard setup
     registerAction(static_cast<unsigned int>(sf::Keyboard::Key::W), "JUMP");
     registerAction(static_cast<unsigned int>(sf::Keyboard::Key::A), "LEFT");
@@ -81,6 +93,18 @@ void ScenePlay::init()
 
     // minimap setup
     m_miniMapView.setViewport(sf::FloatRect({ 0.75f, 0.1f }, { 0.2f, 0.3556f })); /// TODO: customizable size, viewport, etc.
+
+    // tile shader setup, only needed by the chunk mesh render mode
+    m_tileShaderLoaded = sf::Shader::isAvailable() && sf::VertexBuffer::isAvailable() &&
+        m_tileShader.loadFromFile("bin/shaders/tiles.vert", "bin/shaders/tiles.frag");
+    if (m_tileShaderLoaded)
+    {
+        m_tileShader.setUniform("u_mask", m_visibilityMask);
+    }
+    else
+    {
+        std::cerr << "Could not load the tile shader, chunk mesh tile rendering is disabled\n";
+    }
 }
 
 /// @brief loads data that is individual to the specific player, generates world, spawns player
@@ -104,6 +128,14 @@ void ScenePlay::loadGame()
         if (type == "Player")
         {
             file >> m_playerConfig.CW >> m_playerConfig.CH >> m_playerConfig.SX >> m_playerConfig.SY >> m_playerConfig.SM >> m_playerConfig.GRAVITY >> m_playerConfig.BA;
+            m_bulletAnimation = m_game.assets().getAnimationID(m_playerConfig.BA);
+        }
+        else if (type == "Entities")
+        {
+            // initial entity capacity for this mode, the pool still grows past it if needed
+            EntityID capacity;
+            file >> capacity;
+            m_world.reserve(capacity);
         }
         else
         {
@@ -137,114 +169,9 @@ void ScenePlay::generateWorld(int worldSeed)
         - illumiate everything, pretty it up, create edge vector if needed for polygon stuff and new ray casting (updated on changes thereafter)
     */
 
-    // Generate world and get tile positions
-    WorldGenerator gen(m_worldMaxCells.x, m_worldMaxCells.y, worldSeed);
-    gen.generateWorld();
-    const std::vector<TileType>& tileTypes = gen.getTileTypes();
-
-    // Spawn tiles according to their positions in the grid
-    for (int x = 0; x < m_worldMaxCells.x; ++x)
-    {
-        // PROFILE_SCOPE("adding tiles, row x");
-
-        for (int y = 0; y < m_worldMaxCells.y; ++y)
-        {
-            TileType tileType = tileTypes.data()[x * m_worldMaxCells.y + y];
-            if (tileType != TileType::NONE)
-            {
-                // std::cout << "adding tile " << x << ", " << y << std::endl;
-
-                Tile tile;
-                tile.type = tileType;
-                tile.light = 0; /// TODO: instead of propagating light, just make all tiles darker than usual, then render the ones in sight brighter?
-
-                // float randomNumber = Random::getFloatingPoint(0.9f, 1.1f);
-                uint8_t min = 0;
-                uint8_t max = 5;
-                uint8_t randomNumber = Random::getIntegral(min, max); /// TODO: could be faster to use predetermined values or formula, like pseudo-random function of depth or something
-
-                if (tileType == TileType::DIRT)
-                {
-                    tile.health = 40;
-                    // tile.r = static_cast<uint8_t>(50.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(30.0f * randomNumber);
-                    // tile.b = static_cast<uint8_t>(20.0f * randomNumber);
-                    tile.r = 50 + randomNumber;
-                    tile.g = 30 + randomNumber;
-                    tile.b = 20 + randomNumber;
-                    tile.blocksMovement = true;
-                    tile.blocksVision = true;
-                }
-                else if (tileType == TileType::DIRTWALL)
-                {
-                    tile.health = 10;
-                    tile.r = 25 + randomNumber;
-                    tile.g = 15 + randomNumber;
-                    tile.b = 10 + randomNumber;
-                    // tile.r = static_cast<uint8_t>(25.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(15.0f * randomNumber);
-                    // tile.b = static_cast<uint8_t>(10.0f * randomNumber);
-                    tile.blocksMovement = false;
-                    tile.blocksVision = false;
-                }
-                else if (tileType == TileType::STONE)
-                {
-                    tile.health = 60;
-                    // tile.r = static_cast<uint8_t>(70.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(70.0f * randomNumber);
-                    // tile.b = static_cast<uint8_t>(70.0f * randomNumber);
-                    tile.r = 70 + randomNumber;
-                    tile.g = 70 + randomNumber;
-                    tile.b = 70 + randomNumber;
-                    tile.blocksMovement = true;
-                    tile.blocksVision = true;
-                }
-                else if (tileType == TileType::STONEWALL)
-                {
-                    tile.health = 10;
-                    // tile.r = static_cast<uint8_t>(35.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(35.0f * randomNumber);
-                    // tile.b = static_cast<uint8_t>(35.0f * randomNumber);
-                    tile.r = 35 + randomNumber;
-                    tile.g = 35 + randomNumber;
-                    tile.b = 35 + randomNumber;
-                    tile.blocksMovement = false;
-                    tile.blocksVision = false;
-                }
-                else if (tileType == TileType::BRICK)
-                {
-                    tile.health = 100;
-                    // tile.r = static_cast<uint8_t>(50.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(0.0f);
-                    // tile.b = static_cast<uint8_t>(0.0f);
-                    tile.r = 50 + randomNumber;
-                    tile.g = 0;
-                    tile.b = 0;
-                    tile.blocksMovement = true;
-                    tile.blocksVision = true;
-                }
-                else if (tileType == TileType::BRICKWALL)
-                {
-                    tile.health = 10;
-                    // tile.r = static_cast<uint8_t>(25.0f * randomNumber);
-                    // tile.g = static_cast<uint8_t>(0.0f);
-                    // tile.b = static_cast<uint8_t>(0.0f);
-                    tile.r = 25 + randomNumber;
-                    tile.g = 0;
-                    tile.b = 0;
-                    tile.blocksMovement = false;
-                    tile.blocksVision = false;
-                }
-                else
-                {
-                    std::cerr << "invalid tile type: " << tileType << "\n";
-                    exit(-1);
-                }
-
-                m_tileManager.addTile(tile, x, y);
-            }
-        }
-    }
+    // Generate the world chunk by chunk, uniform chunks stay as a single tile type until edited and the rest are generated again when needed
+    m_tileManager.loadWorld(worldSeed);
+    m_minimap.build(m_tileManager);
 }
 
 /**
@@ -266,6 +193,8 @@ void ScenePlay::updateState()
 
         m_game.getNetManager().update(); // do this first, /// TODO: may want to move this to the top/bottom of each function if data isn't arriving in time or something
 
+        m_world.advanceTick(); // component writes from here on are stamped with a new tick
+
         sNetwork(); // get net data and create/destroy entities (rest of network data handled in corresponding systems)
         sStatus(); // lifespan and invincibility time calculations first to not waste calculations on dead entities
         sAnimation(); // update all animations (could move this around)
@@ -274,8 +203,9 @@ void ScenePlay::updateState()
         sProjectiles(); // then iterations of projectile movement and collisions, then projectile spawns
         sAI();
         sCamera(); // finally, set camera
+        sStreaming(); // write far-away tile chunks to disk
 
-        m_entityManager.update(); // add and remove all entities staged during updates above
+        m_entityManager.update(); // sync point, apply recorded commands and add and remove all entities staged during updates above
 
         // lag -= std::chrono::duration<long long, std::nano>(1000000000 / GlobalSettings::frameRate); /// TODO: will rounding be an issue here?
     // }
@@ -289,6 +219,9 @@ void ScenePlay::onEnd()
 {
     PROFILE_FUNCTION();
 
+    // report how many entities this mode needed, so its configured capacity can be tuned
+    std::cout << "Entity high water mark: " << m_world.getHighWaterMark() << " of " << m_world.getCapacity() << " slots\n";
+
     m_game.changeScene("MENU");
 
     /// TODO: stop music, play menu music
@@ -317,19 +250,31 @@ void ScenePlay::sNetwork()
         {
             case NetworkDatum::DataType::SPAWN:
             {
+                // the lobby resends a spawn in every snapshot until one that has it is acknowledged, so it may already be here
+                Entity existing = m_entityManager.getEntity(netMan.getLocalHandle(netDatum.first.id));
+                if (existing.isActive())
+                {
+                    existing.getComponent<CTransform>().pos = Vec2f { netDatum.third.f, netDatum.fourth.f };
+                    break;
+                }
+
                 Entity entity = m_entityManager.addEntity(netDatum.second.type);
                 entity.addComponent<CTransform>(Vec2f { netDatum.third.f, netDatum.fourth.f });
                 entity.addComponent<CBoundingBox>(Vec2f { m_playerConfig.CW, m_playerConfig.CH }, true, true);
-                netMan.updateIDMaps(entity.getID(), netDatum.first.id);
+                netMan.updateIDMaps(entity.getHandle(), netDatum.first.id);
                 break;
             }
 
             case NetworkDatum::DataType::LOCAL_SPAWN:
-                netMan.updateIDMaps(netDatum.first.id, netDatum.second.id);
+                netMan.updateIDMaps(m_entityManager.getEntity(netDatum.first.id).getHandle(), netDatum.second.id);
                 break;
 
             case NetworkDatum::DataType::DESPAWN:
-                m_entityManager.getEntity(netMan.getLocalID(netDatum.first.id)).destroy();
+                m_entityManager.getEntity(netMan.getLocalHandle(netDatum.first.id)).destroy(); // no-op if it's already gone
+                break;
+
+            case NetworkDatum::DataType::SNAPSHOT:
+                netMan.acknowledgeSnapshot(netDatum.first.id); // every datum in the snapshot is handled this frame, here or in sObjectMovement
                 break;
 
             default:
@@ -352,8 +297,11 @@ void ScenePlay::sObjectMovement()
     {
         if (netDatum.dataType == NetworkDatum::DataType::POSITION)
         {
-            EntityID localID = m_game.getNetManager().getLocalID(netDatum.first.id);
-            Entity entity = m_entityManager.getEntity(localID);
+            Entity entity = m_entityManager.getEntity(m_game.getNetManager().getLocalHandle(netDatum.first.id));
+            if (!entity.isActive()) // despawned, or never spawned here
+            {
+                continue;
+            }
 
             entity.getComponent<CTransform>().pos.x = netDatum.second.f;
             entity.getComponent<CTransform>().pos.y = netDatum.third.f;
@@ -368,12 +316,12 @@ void ScenePlay::sObjectMovement()
     // Local player
     if (m_player.isActive())
     {
-        CState& playerState = m_player.getComponent<CState>();
-        CInput& playerInput = m_player.getComponent<CInput>();
+        const CState& playerState = m_player.readComponent<CState>();
+        const CInput& playerInput = m_player.readComponent<CInput>();
         CTransform& playerTrans = m_player.getComponent<CTransform>();
-        CGravity& playerGrav = m_player.getComponent<CGravity>();
+        const CGravity& playerGrav = m_player.readComponent<CGravity>();
         CTransform& weaponTrans = m_weapon.getComponent<CTransform>();
-        CBoundingBox& weaponBox = m_weapon.getComponent<CBoundingBox>();
+        const CBoundingBox& weaponBox = m_weapon.readComponent<CBoundingBox>();
 
         Vec2f velToAdd(0.0f, 0.0f);
 
@@ -513,125 +461,123 @@ void ScenePlay::sObjectMovement()
         // }
     }
 
-    // ragdolls
-    for (Entity& ragA : m_entityManager.getEntities(Entity::Type::RAGDOLL_PART))
+    // ragdolls fall and turn freely, they're the only bodies with both gravity and a lifespan (the player's gravity goes with its input above), so sweep them straight from the storages
+    m_entityManager.view<CTransform, const CGravity, const CLifespan>().each([airResistance](EntityID, CTransform& trans, const CGravity& gravity, const CLifespan&)
     {
-        CTransform& ragATrans = ragA.getComponent<CTransform>();
-        CBoundingBox& ragABox = ragA.getComponent<CBoundingBox>();
-        CGravity& ragAGrav = ragA.getComponent<CGravity>();
-
-        if (ragATrans.velocity.y + ragAGrav.gravity >= airResistance)
+        if (trans.velocity.y + gravity.gravity >= airResistance)
         {
-            ragATrans.velocity.y += airResistance - ragATrans.velocity.y;
+            trans.velocity.y += airResistance - trans.velocity.y;
         }
         else
         {
-            ragATrans.velocity.y += ragAGrav.gravity;
+            trans.velocity.y += gravity.gravity;
         }
 
         // slow down rotation speed over time
-        // if (abs(ragATrans.angularVelocity) >= 0.001)
+        // if (abs(trans.angularVelocity) >= 0.001)
         // {
-        //     ragATrans.angularVelocity += (ragATrans.angularVelocity > 0 ? -0.001f : 0.001f);
+        //     trans.angularVelocity += (trans.angularVelocity > 0 ? -0.001f : 0.001f);
         // }
         // else
         // {
-        //     ragATrans.angularVelocity -= ragATrans.angularVelocity * 0.001f;
+        //     trans.angularVelocity -= trans.angularVelocity * 0.001f;
         // }
 
-        ragATrans.prevPos = ragATrans.pos;
-        ragATrans.pos += ragATrans.velocity / 5.0f;
-        ragATrans.prevAngle = ragATrans.angle;
-        ragATrans.angle += ragATrans.angularVelocity;
+        trans.prevPos = trans.pos;
+        trans.pos += trans.velocity / 5.0f;
+        trans.prevAngle = trans.angle;
+        trans.angle += trans.angularVelocity;
+    });
 
-        /// TODO: do the physics force entity thing here, not just the translation and rotation hard coded fix
-        if (ragA.hasComponent<CJointRelation>())
+    // then pull each jointed part back to the part it hangs off, in list order since each correction moves both parts
+    /// TODO: do the physics force entity thing here, not just the translation and rotation hard coded fix
+    m_entityManager.view<CTransform, const CBoundingBox, const CJointRelation, const CJointInfo>().each(m_entityManager.getEntities(Entity::Type::RAGDOLL_PART), [this](Entity&, CTransform& ragATrans, const CBoundingBox& ragABox, const CJointRelation& joint, const CJointInfo& ragAInfo)
+    {
+        const Entity& ragB = m_entityManager.getEntity(joint.entity);
+        if (!ragB.isActive()) // the part it hangs off may be gone
         {
-            std::cout << "\n\nragA pos: " << ragATrans.pos << "\n";
-            std::cout << "ragA vel: " << ragATrans.velocity << "\n";
-            std::cout << "ragA ang: " << ragATrans.angle << "\n";
-            std::cout << "ragA angVel: " << ragATrans.angularVelocity << "\n";
-
-            CJointRelation& joint = ragA.getComponent<CJointRelation>();
+            return;
+        }
 
-            CJointInfo& ragAInfo = ragA.getComponent<CJointInfo>();
+        std::cout << "\n\nragA pos: " << ragATrans.pos << "\n";
+        std::cout << "ragA vel: " << ragATrans.velocity << "\n";
+        std::cout << "ragA ang: " << ragATrans.angle << "\n";
+        std::cout << "ragA angVel: " << ragATrans.angularVelocity << "\n";
 
-            const Entity& ragB = m_entityManager.getEntity(joint.entityID);
-            CTransform& ragBTrans = ragB.getComponent<CTransform>();
-            CBoundingBox& ragBBox = ragB.getComponent<CBoundingBox>();
-            CJointInfo& ragBInfo = ragB.getComponent<CJointInfo>();
+        CTransform& ragBTrans = ragB.getComponent<CTransform>();
+        const CBoundingBox& ragBBox = ragB.readComponent<CBoundingBox>();
+        const CJointInfo& ragBInfo = ragB.readComponent<CJointInfo>();
 
-            std::cout << "ragB pos: " << ragBTrans.pos << std::endl;
-            std::cout << "ragB vel: " << ragBTrans.velocity << std::endl;
-            std::cout << "ragB ang: " << ragBTrans.angle << "\n";
-            std::cout << "ragB angVel: " << ragBTrans.angularVelocity << "\n";
+        std::cout << "ragB pos: " << ragBTrans.pos << std::endl;
+        std::cout << "ragB vel: " << ragBTrans.velocity << std::endl;
+        std::cout << "ragB ang: " << ragBTrans.angle << "\n";
+        std::cout << "ragB angVel: " << ragBTrans.angularVelocity << "\n";
 
-            float angleDiff = ragBTrans.angle - ragATrans.angle;
-            float angleError = 0.0f;
-            if (angleDiff < joint.minAngle)
-            {
-                angleError = (angleDiff - joint.minAngle) / 2.0f; // < 0
-            }
-            else if (angleDiff > joint.maxAngle)
-            {
-                angleError = (angleDiff - joint.maxAngle) / 2.0f; // > 0
-            }
+        float angleDiff = ragBTrans.angle - ragATrans.angle;
+        float angleError = 0.0f;
+        if (angleDiff < joint.minAngle)
+        {
+            angleError = (angleDiff - joint.minAngle) / 2.0f; // < 0
+        }
+        else if (angleDiff > joint.maxAngle)
+        {
+            angleError = (angleDiff - joint.maxAngle) / 2.0f; // > 0
+        }
 
-            std::cout << "angleDiff: " << angleDiff << "\n";
-            std::cout << "angleError: " << angleError << "\n";
+        std::cout << "angleDiff: " << angleDiff << "\n";
+        std::cout << "angleError: " << angleError << "\n";
 
-            for (int i = 2; i >= 0; --i) // 3 is the size of the joint positions array
+        for (int i = 2; i >= 0; --i) // 3 is the size of the joint positions array
+        {
+            std::cout << "connecting rag A to ragB with pos " << i << std::endl;
+            float jointAOffset = ragAInfo.initJointOffsets.data()[i];
+            if (jointAOffset != 0.0f) // found a joint pos /// TODO: may want to add some theshold or something
             {
-                std::cout << "connecting rag A to ragB with pos " << i << std::endl;
-                float jointAOffset = ragAInfo.initJointOffsets.data()[i];
-                if (jointAOffset != 0.0f) // found a joint pos /// TODO: may want to add some theshold or something
-                {
-                    float jointBOffset = ragBInfo.initJointOffsets.data()[i]; // must be a joint in rag B joint info at same index
+                float jointBOffset = ragBInfo.initJointOffsets.data()[i]; // must be a joint in rag B joint info at same index
 
-                    Vec2f ragAJointPos = ragATrans.pos + Vec2f(0.0f, jointAOffset).rotate(ragATrans.angle);
-                    Vec2f ragBJointPos = ragBTrans.pos + Vec2f(0.0f, jointBOffset).rotate(ragBTrans.angle);
+                Vec2f ragAJointPos = ragATrans.pos + Vec2f(0.0f, jointAOffset).rotate(ragATrans.angle);
+                Vec2f ragBJointPos = ragBTrans.pos + Vec2f(0.0f, jointBOffset).rotate(ragBTrans.angle);
 
-                    if (abs(angleDiff) > 0.0001f)
-                    {
-                        // restrict angle
-                        // ragATrans.angle += angleError;
-                        // ragBTrans.angle -= angleError;
-                        ragATrans.angularVelocity += angleError * 0.01f;
-                        ragBTrans.angularVelocity -= angleError * 0.01f;
-                    }
-
-                    std::cout << "new ragA ang: " << ragATrans.angle << "\n";
-                    std::cout << "new ragA angVel: " << ragATrans.angularVelocity << "\n";
-                    std::cout << "new ragB ang: " << ragBTrans.angle << "\n";
-                    std::cout << "new ragB angVel: " << ragBTrans.angularVelocity << "\n";
+                if (abs(angleDiff) > 0.0001f)
+                {
+                    // restrict angle
+                    // ragATrans.angle += angleError;
+                    // ragBTrans.angle -= angleError;
+                    ragATrans.angularVelocity += angleError * 0.01f;
+                    ragBTrans.angularVelocity -= angleError * 0.01f;
+                }
 
-                    Vec2f diff = ragBJointPos - ragAJointPos;
-                    float dist = diff.length();
+                std::cout << "new ragA ang: " << ragATrans.angle << "\n";
+                std::cout << "new ragA angVel: " << ragATrans.angularVelocity << "\n";
+                std::cout << "new ragB ang: " << ragBTrans.angle << "\n";
+                std::cout << "new ragB angVel: " << ragBTrans.angularVelocity << "\n";
 
-                    std::cout << "diff: " << diff << "\n";
-                    std::cout << "dist: " << dist << "\n";
+                Vec2f diff = ragBJointPos - ragAJointPos;
+                float dist = diff.length();
 
-                    if (dist > 0.0001f)
-                    {
-                        Vec2f correction = diff / 2.0f; /// TODO: by correcting like this (I think), I am cutting the effects of gravity in half
+                std::cout << "diff: " << diff << "\n";
+                std::cout << "dist: " << dist << "\n";
 
-                        // put joints back together
-                        ragATrans.pos += correction;
-                        ragBTrans.pos -= correction;
+                if (dist > 0.0001f)
+                {
+                    Vec2f correction = diff / 2.0f; /// TODO: by correcting like this (I think), I am cutting the effects of gravity in half
 
-                        // apply equal and opposite forces on each joint
-                        Physics::ForceEntity(ragATrans.pos, ragATrans.velocity, ragATrans.angularVelocity, ragABox.size, correction / 10.0f, ragAJointPos);
-                        Physics::ForceEntity(ragBTrans.pos, ragBTrans.velocity, ragBTrans.angularVelocity, ragBBox.size, -correction / 10.0f, ragBJointPos);
-                    }
+                    // put joints back together
+                    ragATrans.pos += correction;
+                    ragBTrans.pos -= correction;
 
-                    break;
+                    // apply equal and opposite forces on each joint
+                    Physics::ForceEntity(ragATrans.pos, ragATrans.velocity, ragATrans.angularVelocity, ragABox.size, correction / 10.0f, ragAJointPos);
+                    Physics::ForceEntity(ragBTrans.pos, ragBTrans.velocity, ragBTrans.angularVelocity, ragBBox.size, -correction / 10.0f, ragBJointPos);
                 }
-            }
 
-            std::cout << "new ragA pos: " << ragATrans.pos << std::endl;
-            std::cout << "new ragB pos: " << ragBTrans.pos << std::endl;
+                break;
+            }
         }
-    }
+
+        std::cout << "new ragA pos: " << ragATrans.pos << std::endl;
+        std::cout << "new ragB pos: " << ragBTrans.pos << std::endl;
+    });
 }
 
 /// TODO: modularize some of this if needed to reduce repition and make it easier to read
@@ -642,18 +588,13 @@ void ScenePlay::sObjectCollision()
     PROFILE_FUNCTION();
 
     // cache once per frame
-    const std::vector<Tile>& tiles = m_tileManager.getTiles();
-
-    playerTileCollisions(tiles);
+    playerTileCollisions();
 
     /// TODO: weapon-tile collisions (like pistol that fell out of someones hand when killed), other object collisions
 
     // ragdoll-tile collisions /// TODO: could just do two vertices on a stick and call it a day (or give the vertices a circular distance for collisions)
-    for (Entity& rag : m_entityManager.getEntities(Entity::Type::RAGDOLL_PART))
+    m_entityManager.view<CTransform, const CBoundingBox>().each(m_entityManager.getEntities(Entity::Type::RAGDOLL_PART), [this](Entity&, CTransform& trans, const CBoundingBox& box)
     {
-        CTransform& trans = rag.getComponent<CTransform>();
-        CBoundingBox& box = rag.getComponent<CBoundingBox>();
-
         std::array<Vec2f, 4> vertices;
         float halfDiag = sqrtf(box.size.x * box.size.x + box.size.y * box.size.y) / 2.0f;
         float angleToVertex0 = asinf(box.halfSize.y / halfDiag); // bottom-right (without trans.angle)
@@ -693,7 +634,7 @@ void ScenePlay::sObjectCollision()
 
             /// TODO: edge case: vert x = 1300 so grid pos = 130, but no resolutions needs to happen
             /// TODO: maybe check multiple times per frame for more accuracy
-            if (tiles.data()[gridPos.x * m_worldMaxCells.y + gridPos.y].blocksMovement) // vertex inside tile /// TODO: possible seg faults
+            if (m_tileManager.inBounds(gridPos.x, gridPos.y) && m_tileManager.blocksMovement(gridPos.x, gridPos.y)) // vertex inside tile
             {
                 // std::cout << "collision with tile" << std::endl;
 
@@ -869,7 +810,7 @@ void ScenePlay::sObjectCollision()
                 /// TODO: trans.pos close enough to trans.prevPos, then don't make a physics update, just freeze it until there is no collision again
             }
         }
-    }
+    });
 }
 
 /// @brief handle all weapon firing logic (and melee if implemented) and projectile movement; decoupled from other entities since updated multiple times per frame; includes CInput, CFire, CTransform, CDamage, CHealth, CType, tile matrix
@@ -925,6 +866,39 @@ void ScenePlay::sDoAction(const Action& action)
         {
             m_drawMinimap = !m_drawMinimap;
         }
+        else if (action.name() == "TOGGLE_WORLD_MAP")
+        {
+            m_drawWorldMap = !m_drawWorldMap;
+        }
+        else if (action.name() == "BENCHMARK_FLOOD_FILL")
+        {
+            benchmarkFloodFill();
+        }
+        else if (action.name() == "BENCHMARK_ENTITY_POOLS")
+        {
+            benchmarkEntityPools();
+        }
+        else if (action.name() == "BENCHMARK_NETWORK")
+        {
+            benchmarkNetworkBandwidth();
+        }
+        else if (action.name() == "TOGGLE_TILE_RENDER")
+        {
+            // cycle TEXTURE -> VERTICES -> CHUNK_MESHES (if the tile shader loaded) -> TEXTURE
+            if (m_tileRenderMode == TileRenderMode::TEXTURE)
+            {
+                m_tileRenderMode = TileRenderMode::VERTICES;
+            }
+            else if (m_tileRenderMode == TileRenderMode::VERTICES && m_tileShaderLoaded)
+            {
+                m_tileRenderMode = TileRenderMode::CHUNK_MESHES;
+            }
+            else
+            {
+                m_tileRenderMode = TileRenderMode::TEXTURE;
+            }
+            m_visibilityCell = { -1, -1 }; // the new mode's cache is stale, refill next frame so everything is rebuilt
+        }
         else if (action.name() == "PAUSE")
         {
             setPaused();
@@ -987,29 +961,28 @@ void ScenePlay::sStatus()
     /// TODO: do same locational thing here as with collision and tileMatrix[x][y]
     /// TODO: may want to separate lifespan and health since shit is stored so that components are cached together, or change the way components and entities are stored
 
-    // bullets lifespan
-    for (Entity& e : m_entityManager.getEntities(Entity::Type::BULLET))
+    // bullets lifespan, bullets are the entities with both a lifespan and damage (ragdoll parts have a lifespan too but don't expire yet)
+    CommandBuffer& commands = m_entityManager.getCommandBuffer();
+    m_entityManager.view<CLifespan, const CDamage>().each([this, &commands](EntityID id, CLifespan& lifespan, const CDamage&)
     {
-        int& lifespan = e.getComponent<CLifespan>().lifespan;
-        if (lifespan <= 0)
+        if (lifespan.lifespan <= 0)
         {
-            e.destroy();
+            commands.destroy(m_entityManager.getEntity(id).getHandle());
         }
         else
         {
-            --lifespan;
+            --lifespan.lifespan;
         }
-    }
+    });
 
-    // players have invincibility times
-    for (Entity& e : m_entityManager.getEntities(Entity::Type::PLAYER))
+    // players have invincibility times, and only players have them
+    m_entityManager.view<CInvincibility>().each([](EntityID, CInvincibility& invincibility)
     {
-        int& invTime = e.getComponent<CInvincibility>().timeRemaining;
-        if (invTime > 0)
+        if (invincibility.timeRemaining > 0)
         {
-            --invTime;
+            --invincibility.timeRemaining;
         }
-    }
+    });
 
     /// TODO: old code that may still be viable, test against current code later, good to iterate through single components at a time for memory speed
     // for (Entity& e : m_entityManager.getEntities())
@@ -1047,10 +1020,11 @@ void ScenePlay::sAnimation()
     /// TODO: create an "animation" which is just data on where each limb should be and what angle it should be at, and could then use this data to control rigid bodies when alive by forcing them toward the angle and position needed. Easy transition to ragdoll from there by just letting the entity bodies fall (they're already created, in the right places, and have the right velocities to have a smooth transition)
     CSkelAnim& playerSkelAnim = m_player.getComponent<CSkelAnim>();
     // CState& playerState = m_player.getComponent<CState>();
-    CTransform& playerTrans = m_player.getComponent<CTransform>();
+    const CTransform& playerTrans = m_player.readComponent<CTransform>();
 
-    playerSkelAnim.skelAnims[static_cast<size_t>(State::WALK)].update(0); /// TODO: change state to playerState
-    const std::array<Bone, 7>& currentBones = playerSkelAnim.skelAnims[static_cast<size_t>(State::WALK)].getCurrentFrame().getBones();
+    const SkelAnim& walk = m_game.assets().getSkelAnim(playerSkelAnim.skelAnims[static_cast<size_t>(State::WALK)]); /// TODO: change state to playerState
+    walk.sample(playerSkelAnim.lastKeyFrameIdx, playerSkelAnim.timeSinceLastKeyFrame, playerSkelAnim.currentFrame);
+    const std::array<Bone, 7>& currentBones = playerSkelAnim.currentFrame.getBones();
     Vec2f scale { AnimConfig::scaleFactor, AnimConfig::scaleFactor }; /// TODO: could set scales in the spawn area since they won't change ever
 
     /// TODO: consider having CKeyFrame instead of storing everything in a component (memory pool for each entity) and use the SkelAnim class in sAnimation to update CKeyFrame (would also not have to check CState then), would also make things cleaner
@@ -1091,7 +1065,7 @@ void ScenePlay::sCamera()
 {
     PROFILE_FUNCTION();
 
-    Vec2f& pPos = m_player.getComponent<CTransform>().pos;
+    const Vec2f& pPos = m_player.readComponent<CTransform>().pos;
 
     // center the view on the player
     const Vec2i& viewSize { static_cast<int>(m_game.window().getSize().x), static_cast<int>(m_game.window().getSize().y) };
@@ -1107,6 +1081,22 @@ void ScenePlay::sCamera()
     // view.move({ dx, dy });
 }
 
+/// @brief keeps tile chunks in view of any player in memory and evicts the rest
+void ScenePlay::sStreaming()
+{
+    PROFILE_FUNCTION();
+
+    std::vector<Vec2i> playerCells;
+    playerCells.emplace_back((m_player.readComponent<CTransform>().pos / m_cellSizePixels).to<int>());
+    for (Entity& enemy : m_entityManager.getEntities(Entity::Type::ENEMY))
+    {
+        playerCells.emplace_back((enemy.readComponent<CTransform>().pos / m_cellSizePixels).to<int>());
+    }
+
+    const Vec2f mainViewSize { m_mainView.getSize().x, m_mainView.getSize().y };
+    m_tileManager.streamChunks(playerCells, (mainViewSize / m_cellSizePixels / 2.0f).to<int>());
+}
+
 /// @brief handles all rendering of textures (animations), grid boxes, collision boxes, and fps counter; includes CTransform, CAnimation, tile matrix
 /// @todo doing a lot of "get all entities of this type and do the shit", but if I'm going through them all then maybe I should just do a "get all entities and do everything for each component at a time" type deal
 void ScenePlay::sRender()
@@ -1117,8 +1107,7 @@ void ScenePlay::sRender()
     window.setView(m_mainView);
     window.clear(sf::Color(10, 10, 10));
 
-    const CTransform& playerTrans = m_player.getComponent<CTransform>();
-    std::vector<Tile>& tiles = m_tileManager.getTiles();
+    const CTransform& playerTrans = m_player.readComponent<CTransform>();
 
     // collidable layer (tiles, player, bullets, items), this comes last so it's always visible
     Vec2i playerGridPos = (playerTrans.pos / m_cellSizePixels).to<int>(); // signed, for operations below /// NOTE: grid pos 0 means pixel 0 through 9
@@ -1133,15 +1122,47 @@ void ScenePlay::sRender()
     int maxY = std::min(m_worldMaxCells.y - 1, playerGridPos.y + checkLength.y);
 
     // find open air tiles method for visible tiles
-    std::vector<Vec2i> openTiles; /// TODO: use these for vertices method, might not even need it and could just use visited
-    std::vector<Vec2i> tileStack;
-    std::vector<char> visited(static_cast<size_t>((maxX - minX + 1) * (maxY - minY + 1))); // + 1 since we include both the min and max values
-
     /// TODO: could use rough ray tracing (fixed number of rays in all directions) to get the set of visible tiles (not all open like this) and then use those tiles with good ray tracing, then still render everything or do light prop or whatever
     /// TODO: could even keep this and render only tiles with ray trace vertices
+    bool visibilityChanged = false; // open tiles changed, blocks and fan must be rebuilt
+    bool tilesChanged = false; // a tile in view changed type, blocks must be rebuilt
     {
         PROFILE_SCOPE("find open tiles");
-        findOpenTiles(playerGridPos.x, playerGridPos.y, minX, maxX, minY, maxY, tiles, openTiles, tileStack, visited);
+
+        const std::array<int, 4> bounds { minX, maxX, minY, maxY };
+        const TileBitset& visionLayer = m_tileManager.getVisionLayer();
+        std::span<const TileEdit> edits;
+        bool rebuild = playerGridPos != m_visibilityCell || bounds != m_visibilityBounds ||
+            !m_tileManager.getEditsSince(m_visibilityGeneration, edits);
+
+        // only the tiles that were edited since the last frame can change what's visible from the same cell
+        for (size_t i = 0; i < edits.size() && !rebuild; ++i)
+        {
+            const Vec2i& cell = edits[i].cell;
+            if (!m_floodFill.contains(cell.x, cell.y))
+            {
+                continue;
+            }
+
+            tilesChanged = true;
+            if (m_floodFill.reopen(visionLayer, cell))
+            {
+                visibilityChanged = true;
+            }
+            else if (m_floodFill.isVisited(cell.x, cell.y) && visionLayer.test(cell.x, cell.y))
+            {
+                rebuild = true; // an open cell started blocking vision, the fill can only grow incrementally
+            }
+        }
+
+        if (rebuild)
+        {
+            m_floodFill.run(visionLayer, playerGridPos, minX, maxX, minY, maxY);
+            m_visibilityCell = playerGridPos;
+            m_visibilityBounds = bounds;
+            visibilityChanged = true;
+        }
+        m_visibilityGeneration = m_tileManager.getEditGeneration();
     }
 
     /// TODO: slow, could use some other sort of logic (either just logic same process or different entirely like lighting based on distance to player and/or light cone direction) after taking another look at the recrsive func efficiency
@@ -1149,9 +1170,49 @@ void ScenePlay::sRender()
     {
         PROFILE_SCOPE("blocks");
 
-        /// TODO: test speed with texture and sprite, drawing to a texture pixel by pixel (taking advantage of single-pixel tiles), scaling, then rendering
-        sf::VertexArray blocks(sf::PrimitiveType::Triangles);
+        if (m_tileRenderMode == TileRenderMode::TEXTURE)
+        {
+            m_tileTexture.update(m_tileManager, m_floodFill, minX, maxX, minY, maxY, visibilityChanged);
+            m_tileTexture.draw(window);
+        }
+        else if (m_tileRenderMode == TileRenderMode::CHUNK_MESHES)
+        {
+            const int maskWidth = maxX - minX + 1;
+            const int maskHeight = maxY - minY + 1;
+            if (visibilityChanged)
+            {
+                const sf::Vector2u maskSize { static_cast<unsigned int>(maskWidth), static_cast<unsigned int>(maskHeight) };
+                if (m_visibilityMask.getSize() != maskSize && !m_visibilityMask.resize(maskSize))
+                {
+                    std::cerr << "Could not create the visibility mask texture\n";
+                    exit(-1);
+                }
+
+                m_visibilityMaskPixels.resize(static_cast<size_t>(maskWidth * maskHeight * 4));
+                for (int y = minY; y <= maxY; ++y)
+                {
+                    for (int x = minX; x <= maxX; ++x)
+                    {
+                        const uint8_t value = m_floodFill.isVisited(x, y) ? 255 : 0;
+                        std::fill_n(&m_visibilityMaskPixels[static_cast<size_t>(((y - minY) * maskWidth + (x - minX)) * 4)], 4, value);
+                    }
+                }
+                m_visibilityMask.update(m_visibilityMaskPixels.data());
+            }
+
+            // meshes only change where tiles were edited, the shader discards every cell the mask doesn't mark as visible
+            m_tileMeshes.update(m_tileManager, minX, maxX, minY, maxY);
+            m_tileShader.setUniform("u_maskOrigin", sf::Vector2f(static_cast<float>(minX * m_cellSizePixels), static_cast<float>(minY * m_cellSizePixels)));
+            m_tileShader.setUniform("u_maskSize", sf::Vector2f(static_cast<float>(maskWidth * m_cellSizePixels), static_cast<float>(maskHeight * m_cellSizePixels)));
+
+            sf::RenderStates states;
+            states.shader = &m_tileShader;
+            m_tileMeshes.draw(window, states, minX, maxX, minY, maxY);
+        }
+
+        sf::VertexArray& blocks = m_visibleBlocks;
         sf::Color c;
+        const bool rebuildBlocks = m_tileRenderMode == TileRenderMode::VERTICES && (visibilityChanged || tilesChanged);
 
         // method of rendering only tiles that have a vertex in triangle fan
         // for (const Vec2f& vert : triangleFan)
@@ -1236,24 +1297,28 @@ void ScenePlay::sRender()
 
         // method of rendering all visited tiles
         /// TODO: render tiles with no tile above them and 1 or two tiles missing to the side as ramps and deal with that accordingly in collisions
-        for (int x = minX; x <= maxX; ++x)
+        if (rebuildBlocks)
+        {
+            blocks.clear();
+        }
+        for (int x = minX; x <= maxX && rebuildBlocks; ++x)
         {
             for (int y = minY; y <= maxY; ++y)
             {
-                if (visited.data()[(x - minX) * (maxY - minY + 1) + (y - minY)])
+                if (m_floodFill.isVisited(x, y))
                 {
-                    Tile& tile = tiles.data()[x * m_worldMaxCells.y + y];
+                    const Tile tile = m_tileManager.getTile(x, y);
                     if (tile.health)
                     {
                         // Vec2i startCoord(x, y);
                         // Vec2i currentCoord = startCoord;
                         // propagateLight(blocks, 3, 0, startCoord, currentCoord, minX, maxX, minY, maxY);
 
-                        tile.light = 255;
-                        c.r = tile.r;
-                        c.g = tile.g;
-                        c.b = tile.b;
-                        c.a = tile.light;
+                        const TileColor color = TileManager::getColor(tile.type, x, y);
+                        c.r = color.r;
+                        c.g = color.g;
+                        c.b = color.b;
+                        c.a = 255; /// TODO: instead of propagating light, just make all tiles darker than usual, then render the ones in sight brighter?
                         addBlock(blocks, static_cast<int>(x), static_cast<int>(y), c);
 
                         // draw neighbors with less lighting
@@ -1447,7 +1512,10 @@ void ScenePlay::sRender()
             }
         }
 
-        window.draw(blocks);
+        if (m_tileRenderMode == TileRenderMode::VERTICES)
+        {
+            window.draw(m_visibleBlocks);
+        }
 
         // reset lighting for light propagation /// TODO: consider using a visited array, maybe the same as used for findOpenTiles instead of using this light thing (adds this loop)
         // for (int x = minX; x <= maxX; ++x)
@@ -1459,45 +1527,57 @@ void ScenePlay::sRender()
         // }
     }
 
-    // Ray casting
-    std::vector<Vec2f> triangleFan = rayCast(Vec2f(m_mainView.getCenter().x, m_mainView.getCenter().y), Vec2f(mainViewSize.x, mainViewSize.y), openTiles, playerTrans.pos, tiles, minX, maxX, minY, maxY);
-    sf::VertexArray fan(sf::PrimitiveType::TriangleFan, triangleFan.size());
-    for (size_t i = 0; i < triangleFan.size(); ++i)
+    // Ray casting, the fan starts at the player's exact position so it's keyed on that rather than the grid cell
+    if (visibilityChanged)
+    {
+        PROFILE_SCOPE("edge segments");
+        m_visionSegments.clear();
+        m_tileManager.getVisionEdges().collect(minX, maxX, minY, maxY, m_visionSegments);
+    }
+    if (visibilityChanged || playerTrans.pos != m_fanOrigin)
     {
-        fan[i].position = sf::Vector2f { triangleFan[i].x, triangleFan[i].y };
-        fan[i].color = sf::Color { 255, 255, 255, 50 };
+        PROFILE_SCOPE("ray cast");
+        m_fanOrigin = playerTrans.pos;
+
+        m_visibilityPolygon.build(m_tileManager.getVisionLayer(), m_floodFill, m_visionSegments, playerTrans.pos, minX, maxX, minY, maxY, m_cellSizePixels);
+        const std::vector<Vec2f>& triangleFan = m_visibilityPolygon.getFan();
+        sf::VertexArray& fan = m_visibilityFan;
+        fan.resize(triangleFan.size());
+        for (size_t i = 0; i < triangleFan.size(); ++i)
+        {
+            fan[i].position = sf::Vector2f { triangleFan[i].x, triangleFan[i].y };
+            fan[i].color = sf::Color { 255, 255, 255, 50 };
 
-        // sf::CircleShape dot(2);
-        // dot.setPosition({ static_cast<float>(triangleFan[i].x - 2), static_cast<float>(triangleFan[i].y - 2) });
-        // dot.setFillColor(sf::Color(0, 0, 255, 100));
-        // window.draw(dot);
+            // sf::CircleShape dot(2);
+            // dot.setPosition({ static_cast<float>(triangleFan[i].x - 2), static_cast<float>(triangleFan[i].y - 2) });
+            // dot.setFillColor(sf::Color(0, 0, 255, 100));
+            // window.draw(dot);
+        }
     }
-    window.draw(fan);
+    window.draw(m_visibilityFan);
+
+    const Assets& assets = m_game.assets();
 
     // Bullets
-    for (Entity& bullet : m_entityManager.getEntities(Entity::Type::BULLET))
+    m_entityManager.view<const CTransform, const CAnimation>().each(m_entityManager.getEntities(Entity::Type::BULLET), [&window, &assets](Entity&, const CTransform& transform, const CAnimation& animation)
     {
-        const CTransform& transform = bullet.getComponent<CTransform>();
-
-        sf::Sprite& sprite = bullet.getComponent<CAnimation>().animation.getSprite();
+        sf::Sprite sprite = assets.getAnimation(animation.id).makeSprite(animation.frame);
         sprite.setRotation(sf::radians(transform.angle));
         sprite.setPosition({ transform.pos.x, transform.pos.y });
         sprite.setScale({ transform.scale.x, transform.scale.y });
 
         window.draw(sprite);
-    }
+    });
 
     // Ragdolls
-    for (Entity& rag : m_entityManager.getEntities(Entity::Type::RAGDOLL_PART))
+    m_entityManager.view<const CTransform, const CAnimation, const CBoundingBox>().each(m_entityManager.getEntities(Entity::Type::RAGDOLL_PART), [&window, &assets](Entity&, const CTransform& trans, const CAnimation& animation, const CBoundingBox& box)
     {
-        const CTransform& trans = rag.getComponent<CTransform>();
-        sf::Sprite& sprite = rag.getComponent<CAnimation>().animation.getSprite();
+        sf::Sprite sprite = assets.getAnimation(animation.id).makeSprite(animation.frame);
         sprite.setPosition({ trans.pos.x, trans.pos.y });
         sprite.setRotation(sf::radians(trans.angle));
         window.draw(sprite);
 
         // draw bounding box
-        const CBoundingBox& box = rag.getComponent<CBoundingBox>();
         sf::RectangleShape rect;
         rect.setSize({ box.size.x - 1.0f, box.size.y - 1.0f }); // - 1 cuz line thickness of 1?
         rect.setOrigin({ box.halfSize.x, box.halfSize.y });
@@ -1507,21 +1587,18 @@ void ScenePlay::sRender()
         rect.setOutlineColor(sf::Color::White);
         rect.setOutlineThickness(1);
         window.draw(rect);
-    }
+    });
 
     // Enenmy players
-    for (Entity& enemy : m_entityManager.getEntities(Entity::Type::ENEMY))
+    m_entityManager.view<const CTransform, const CBoundingBox>().each(m_entityManager.getEntities(Entity::Type::ENEMY), [&window](Entity&, const CTransform& trans, const CBoundingBox& box)
     {
-        const CTransform& trans = enemy.getComponent<CTransform>();
-        const CBoundingBox& box = enemy.getComponent<CBoundingBox>();
-
         sf::RectangleShape rect;
         rect.setSize({ box.size.x, box.size.y });
         rect.setOrigin({ box.halfSize.x, box.halfSize.y });
         rect.setPosition({ trans.pos.x, trans.pos.y });
         rect.setFillColor(sf::Color::Red);
         window.draw(rect);
-    }
+    });
 
     // Player parts and weapon held
     if (m_player.isActive())
@@ -1547,8 +1624,8 @@ void ScenePlay::sRender()
 
         // Temporary shit
         {
-            const CTransform& trans = m_player.getComponent<CTransform>();
-            const CBoundingBox& box = m_player.getComponent<CBoundingBox>();
+            const CTransform& trans = m_player.readComponent<CTransform>();
+            const CBoundingBox& box = m_player.readComponent<CBoundingBox>();
             sf::RectangleShape rect;
             rect.setSize({ box.size.x, box.size.y });
             rect.setOrigin({ box.halfSize.x, box.halfSize.y });
@@ -1559,12 +1636,12 @@ void ScenePlay::sRender()
 
         // Health bar
         sf::RectangleShape healthBarOutline({ 30, 5 });
-        CBoundingBox& playerBox = m_player.getComponent<CBoundingBox>();
+        const CBoundingBox& playerBox = m_player.readComponent<CBoundingBox>();
         healthBarOutline.setPosition({ playerTrans.pos.x - 15, playerTrans.pos.y - playerBox.halfSize.y - 15 });
         healthBarOutline.setOutlineColor(sf::Color::White);
         healthBarOutline.setOutlineThickness(1);
         healthBarOutline.setFillColor(sf::Color::Transparent);
-        CHealth& playerHealth = m_player.getComponent<CHealth>();
+        const CHealth& playerHealth = m_player.readComponent<CHealth>();
         sf::RectangleShape healthBar({ static_cast<float>(playerHealth.current) / static_cast<float>(playerHealth.max) * 30, 5 });
         healthBar.setPosition({ playerTrans.pos.x - 15, playerTrans.pos.y - playerBox.halfSize.y - 15 });
         healthBar.setFillColor(sf::Color::Red);
@@ -1572,8 +1649,9 @@ void ScenePlay::sRender()
         window.draw(healthBar);
 
         // Weapon
-        const CTransform& weaponTrans = m_weapon.getComponent<CTransform>();
-        sf::Sprite& weaponSprite = m_weapon.getComponent<CAnimation>().animation.getSprite();
+        const CTransform& weaponTrans = m_weapon.readComponent<CTransform>();
+        const CAnimation& weaponAnim = m_weapon.readComponent<CAnimation>();
+        sf::Sprite weaponSprite = assets.getAnimation(weaponAnim.id).makeSprite(weaponAnim.frame);
         weaponSprite.setPosition({ weaponTrans.pos.x, weaponTrans.pos.y });
         weaponSprite.setScale({ weaponTrans.scale.x, weaponTrans.scale.y });
         weaponSprite.setRotation(sf::radians(weaponTrans.angle));
@@ -1634,8 +1712,8 @@ void ScenePlay::sRender()
     // may be able to do this my own way since places where light should extend(but wouldn't with the connect-the-dots method if not using the extra two ways for every vertex-aiming ray) do not have a ray that intersects a line between them
 
     /// minimap
-    /// TODO: use single small texture for this and scale it or use vertexarray with points (if they're pixels) that are scaled or triangles
-    /// TODO: consider using sf::Image, look into it; if not, create small and render scaled, just like tiles in main game
+    // patched every frame, even while hidden, so the edit log never falls far enough behind to force a rebuild
+    m_minimap.update(m_tileManager);
     if (m_drawMinimap)
     {
         PROFILE_SCOPE("rendering minimap");
@@ -1655,30 +1733,35 @@ void ScenePlay::sRender()
         player.setPosition({ m_miniMapView.getCenter().x - 5, m_miniMapView.getCenter().y - 5 });
         window.draw(player);
 
-        /// @todo change this later to use some set zoom or something for the minimap (have a separate view for opening the whole map)
-        minX = std::max(0, playerGridPos.x - checkLength.x * 10);
-        maxX = std::min(m_worldMaxCells.x - 1, playerGridPos.x + checkLength.x * 10);
-        minY = std::max(0, playerGridPos.y - checkLength.y * 10);
-        maxY = std::min(m_worldMaxCells.y - 1, playerGridPos.y + checkLength.y * 10);
+        // tiles, texel (x, y) is cell (x, y) and the minimap view is in cells, so the view alone places and crops the whole-world sprite
+        window.draw(sf::Sprite(m_minimap.getTexture()));
+    }
 
-        sf::VertexArray points(sf::PrimitiveType::Points);
-        sf::Color c;
-        for (int x = minX; x <= maxX; ++x)
-        {
-            for (int y = minY; y <= maxY; ++y)
-            {
-                Tile& tile = tiles.data()[x * m_worldMaxCells.y + y];
-                if (tile.blocksMovement || tile.blocksVision)
-                {
-                    c.r = tile.r;
-                    c.g = tile.g;
-                    c.b = tile.b;
-                    sf::Vertex v = { sf::Vector2f(x, y), c };
-                    points.append(v);
-                }
-            }
-        }
-        window.draw(points);
+    /// world map, the whole world over most of the window
+    if (m_drawWorldMap)
+    {
+        PROFILE_SCOPE("rendering world map");
+
+        const sf::Vector2f worldSize { static_cast<float>(m_worldMaxCells.x), static_cast<float>(m_worldMaxCells.y) };
+        const sf::Vector2f windowSize { static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y) };
+        const float viewportWidth = 0.9f;
+        const float viewportHeight = std::min(0.9f, viewportWidth * windowSize.x / worldSize.x * worldSize.y / windowSize.y); // keep the world's aspect ratio
+
+        sf::View worldMapView(sf::FloatRect({ 0.0f, 0.0f }, worldSize));
+        worldMapView.setViewport(sf::FloatRect({ (1.0f - viewportWidth) / 2.0f, (1.0f - viewportHeight) / 2.0f }, { viewportWidth, viewportHeight }));
+        window.setView(worldMapView);
+
+        sf::RectangleShape worldMapBackground(worldSize);
+        worldMapBackground.setFillColor(sf::Color(50, 50, 50));
+        window.draw(worldMapBackground);
+        window.draw(sf::Sprite(m_minimap.getTexture()));
+
+        // player icon
+        const float iconRadius = worldSize.x / 200.0f;
+        sf::CircleShape player(iconRadius);
+        player.setFillColor(sf::Color::Green);
+        player.setPosition({ playerGridPos.x - iconRadius, playerGridPos.y - iconRadius });
+        window.draw(player);
     }
 
     window.display();
@@ -1695,7 +1778,7 @@ Vec2f ScenePlay::gridToMidPixel(float gridX, float gridY, Entity entity)
 {
     PROFILE_FUNCTION();
 
-    const Vec2f& bBoxHalfSize = entity.getComponent<CBoundingBox>().halfSize;
+    const Vec2f& bBoxHalfSize = entity.readComponent<CBoundingBox>().halfSize;
 
     float xPos = gridX * m_cellSizePixels + bBoxHalfSize.x;
     float yPos = gridY * m_cellSizePixels + bBoxHalfSize.y;
@@ -1725,69 +1808,68 @@ void ScenePlay::spawnPlayer()
     m_player.addComponent<CInvincibility>(30); // in frames for now, will change /// TODO: that
     m_player.addComponent<CHealth>(100);
 
-    std::vector<SkelAnim> playerAnim { static_cast<size_t>(State::NUM_STATES) };
-    playerAnim[static_cast<size_t>(State::WALK)] = AnimConfig::walkKeyFrames;
 
-    m_player.addComponent<CSkelAnim>(playerAnim);
+    CSkelAnim& playerSkelAnim = m_player.addComponent<CSkelAnim>();
+    playerSkelAnim.skelAnims[static_cast<size_t>(State::WALK)] = m_game.assets().getSkelAnimID("Walk");
 
     /// @todo set scales of parts here
     // Set player body parts components
     m_leftHandFront = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftHandFront.addComponent<CTransform>();
-    m_leftHandFront.addComponent<CAnimation>(m_game.assets().getAnimation("LeftHandFront"), false);
+    m_leftHandFront.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftHandFront"), false);
     m_leftHandBack = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftHandBack.addComponent<CTransform>();
-    m_leftHandBack.addComponent<CAnimation>(m_game.assets().getAnimation("LeftHandBack"), false);
+    m_leftHandBack.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftHandBack"), false);
     m_leftForearm = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftForearm.addComponent<CTransform>();
-    m_leftForearm.addComponent<CAnimation>(m_game.assets().getAnimation("LeftForearm"), false);
+    m_leftForearm.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftForearm"), false);
     m_leftUpperArm = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftUpperArm.addComponent<CTransform>();
-    m_leftUpperArm.addComponent<CAnimation>(m_game.assets().getAnimation("LeftUpperArm"), false);
+    m_leftUpperArm.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftUpperArm"), false);
     m_leftFoot = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftFoot.addComponent<CTransform>();
-    m_leftFoot.addComponent<CAnimation>(m_game.assets().getAnimation("LeftFoot"), false);
+    m_leftFoot.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftFoot"), false);
     m_leftCalf = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftCalf.addComponent<CTransform>();
-    m_leftCalf.addComponent<CAnimation>(m_game.assets().getAnimation("LeftCalf"), false);
+    m_leftCalf.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftCalf"), false);
     m_leftThigh = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_leftThigh.addComponent<CTransform>();
-    m_leftThigh.addComponent<CAnimation>(m_game.assets().getAnimation("LeftThigh"), false);
+    m_leftThigh.addComponent<CAnimation>(m_game.assets().getAnimationID("LeftThigh"), false);
     m_head = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_head.addComponent<CTransform>();
-    m_head.addComponent<CAnimation>(m_game.assets().getAnimation("Head"), false);
+    m_head.addComponent<CAnimation>(m_game.assets().getAnimationID("Head"), false);
     m_torso = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_torso.addComponent<CTransform>();
-    m_torso.addComponent<CAnimation>(m_game.assets().getAnimation("Torso"), false);
+    m_torso.addComponent<CAnimation>(m_game.assets().getAnimationID("Torso"), false);
     m_rightFoot = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightFoot.addComponent<CTransform>();
-    m_rightFoot.addComponent<CAnimation>(m_game.assets().getAnimation("RightFoot"), false);
+    m_rightFoot.addComponent<CAnimation>(m_game.assets().getAnimationID("RightFoot"), false);
     m_rightCalf = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightCalf.addComponent<CTransform>();
-    m_rightCalf.addComponent<CAnimation>(m_game.assets().getAnimation("RightCalf"), false);
+    m_rightCalf.addComponent<CAnimation>(m_game.assets().getAnimationID("RightCalf"), false);
     m_rightThigh = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightThigh.addComponent<CTransform>();
-    m_rightThigh.addComponent<CAnimation>(m_game.assets().getAnimation("RightThigh"), false);
+    m_rightThigh.addComponent<CAnimation>(m_game.assets().getAnimationID("RightThigh"), false);
     m_rightHandBack = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightHandBack.addComponent<CTransform>();
-    m_rightHandBack.addComponent<CAnimation>(m_game.assets().getAnimation("RightHandBack"), false);
+    m_rightHandBack.addComponent<CAnimation>(m_game.assets().getAnimationID("RightHandBack"), false);
     m_rightHandFront = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightHandFront.addComponent<CTransform>();
-    m_rightHandFront.addComponent<CAnimation>(m_game.assets().getAnimation("RightHandFront"), false);
+    m_rightHandFront.addComponent<CAnimation>(m_game.assets().getAnimationID("RightHandFront"), false);
     m_rightForearm = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightForearm.addComponent<CTransform>();
-    m_rightForearm.addComponent<CAnimation>(m_game.assets().getAnimation("RightForearm"), false);
+    m_rightForearm.addComponent<CAnimation>(m_game.assets().getAnimationID("RightForearm"), false);
     m_rightUpperArm = m_entityManager.addEntity(Entity::Type::BODY_PART);
     m_rightUpperArm.addComponent<CTransform>();
-    m_rightUpperArm.addComponent<CAnimation>(m_game.assets().getAnimation("RightUpperArm"), false);
+    m_rightUpperArm.addComponent<CAnimation>(m_game.assets().getAnimationID("RightUpperArm"), false);
 
     // Send player spawn to network
     NetworkDatum data {
         .dataType = NetworkDatum::DataType::SPAWN,
         .first.id = m_player.getID(),
         .second.type = Entity::Type::PLAYER,
-        .third.f = m_player.getComponent<CTransform>().pos.x,
-        .fourth.f = m_player.getComponent<CTransform>().pos.y
+        .third.f = m_player.readComponent<CTransform>().pos.x,
+        .fourth.f = m_player.readComponent<CTransform>().pos.y
     };
     m_game.getNetManager().sendData(data);
 
@@ -1795,9 +1877,9 @@ void ScenePlay::spawnPlayer()
     m_weapon = m_entityManager.addEntity(Entity::Type::WEAPON);
     m_weapon.addComponent<CFire>(50, 0.97f, 1.0f);
     m_weapon.addComponent<CDamage>(50);
-    m_weapon.addComponent<CTransform>(m_player.getComponent<CTransform>().pos).scale = Vec2f { 0.3f, 0.3f }; /// TODO: make this a lil infront of player
+    m_weapon.addComponent<CTransform>(m_player.readComponent<CTransform>().pos).scale = Vec2f { 0.3f, 0.3f }; /// TODO: make this a lil infront of player
     m_weapon.addComponent<CBoundingBox>(Vec2f { 50.0f, 10.0f }, false, false); /// TODO: make this dynamic for each weapon
-    m_weapon.addComponent<CAnimation>(m_game.assets().getAnimation("Weapon"), false);
+    m_weapon.addComponent<CAnimation>(m_game.assets().getAnimationID("Weapon"), false);
     /// TODO: add animation, gravity, bounding box, transform, state, etc. since weapons will drop from player on death
 }
 
@@ -1806,9 +1888,9 @@ void ScenePlay::spawnBullet(Entity entity)
 {
     PROFILE_FUNCTION();
 
-    CTransform& entityTrans = entity.getComponent<CTransform>();
-    CBoundingBox& entityBox = entity.getComponent<CBoundingBox>();
-    CFire& entityFire = entity.getComponent<CFire>();
+    const CTransform& entityTrans = entity.readComponent<CTransform>();
+    const CBoundingBox& entityBox = entity.readComponent<CBoundingBox>();
+    const CFire& entityFire = entity.readComponent<CFire>();
 
     Vec2f spawnPos = entityTrans.pos + Vec2f(cosf(entityTrans.angle), sinf(entityTrans.angle)) * entityBox.halfSize.x;
     float bulletSpeed = 1.5f; // number of pixels added to bullet on each update
@@ -1819,21 +1901,21 @@ void ScenePlay::spawnBullet(Entity entity)
 
     Entity bullet = m_entityManager.addEntity(Entity::Type::BULLET);
     bullet.addComponent<CTransform>(spawnPos, bulletVec * bulletSpeed / (worldTarget - entityTrans.pos).length(), Vec2f(2.0f, 2.0f), bulletVec.angle(), 0.0f);
-    bullet.addComponent<CAnimation>(m_game.assets().getAnimation(m_playerConfig.BA), false);
+    bullet.addComponent<CAnimation>(m_bulletAnimation, false);
     bullet.addComponent<CLifespan>(300);
-    bullet.addComponent<CDamage>(entity.getComponent<CDamage>().damage);
+    bullet.addComponent<CDamage>(entity.readComponent<CDamage>().damage);
 
     m_game.assets().playSound("Bullet");
 }
 
 /// @brief handle player-tile collisions and player state updates
 /// TODO: update for ramp tiles to walk up stairs or hills
-void ScenePlay::playerTileCollisions(const std::vector<Tile>& tiles)
+void ScenePlay::playerTileCollisions()
 {
     PROFILE_FUNCTION();
 
     CTransform& playerTrans = m_player.getComponent<CTransform>();
-    CBoundingBox& playerBounds = m_player.getComponent<CBoundingBox>();
+    const CBoundingBox& playerBounds = m_player.readComponent<CBoundingBox>();
     CState& playerState = m_player.getComponent<CState>();
     // CInput& playerInput = m_player.getComponent<CInput>();
 
@@ -1850,13 +1932,14 @@ void ScenePlay::playerTileCollisions(const std::vector<Tile>& tiles)
     const int minY = std::max(0, playerGridPos.y - checkLength.y);
     const int maxY = std::min(m_worldMaxCells.y - 1, playerGridPos.y + checkLength.y);
 
-    for (int x = minX; x <= maxX; ++x)
+    // skip the per-cell checks with a few word tests when no solid tile is in range (e.g. while in the air)
+    const bool nearSolid = m_tileManager.getMovementLayer().anyInRect(minX, maxX, minY, maxY);
+
+    for (int x = minX; x <= maxX && nearSolid; ++x)
     {
         for (int y = minY; y <= maxY; ++y)
         {
-            const Tile& tile = tiles.data()[x * m_worldMaxCells.y + y];
-
-            if (tile.blocksMovement)
+            if (m_tileManager.blocksMovement(x, y))
             {
                 // finding overlap (without tile bounding boxes)
                 float xDiff = abs(playerTrans.pos.x - (x + 0.5f) * m_cellSizePixels);
@@ -1924,7 +2007,7 @@ void ScenePlay::playerTileCollisions(const std::vector<Tile>& tiles)
     }
 
     // restrict player movement passed top, bottom, or side of map
-    const Vec2f& bBoxHalfSize = m_player.getComponent<CBoundingBox>().halfSize;
+    const Vec2f& bBoxHalfSize = m_player.readComponent<CBoundingBox>().halfSize;
     if (playerTrans.pos.x < bBoxHalfSize.x)
     {
         playerTrans.pos.x = bBoxHalfSize.x;
@@ -1962,7 +2045,7 @@ void ScenePlay::playerTileCollisions(const std::vector<Tile>& tiles)
 /// @brief handle bullet-tile collisions
 /// TODO: for super fast bullets or just laser tracing whatver it's called, do a line intersect check - easy with tiles since I can just check grid positions along the line from entity to click spot and stop at first intersect
 /// TODO: for fast bullets but still projectiles, update the bullet system more than once per game frame
-void ScenePlay::projectileTileCollisions(std::vector<Tile>& tiles, std::vector<Entity>& bullets)
+void ScenePlay::projectileTileCollisions(std::vector<Entity>& bullets)
 {
     PROFILE_FUNCTION();
 
@@ -1984,10 +2067,9 @@ void ScenePlay::projectileTileCollisions(std::vector<Tile>& tiles, std::vector<E
             continue;
         }
 
-        Tile& tile = tiles.data()[bulletGridPos.x * m_worldMaxCells.y + bulletGridPos.y];
-
-        if (tile.blocksMovement) /// TODO: get a blocksProjectiles member? maybe blocks movement but not projectiles, or other way around
+        if (m_tileManager.blocksMovement(bulletGridPos.x, bulletGridPos.y)) /// TODO: get a blocksProjectiles member? maybe blocks movement but not projectiles, or other way around
         {
+            Tile tile = m_tileManager.getTile(bulletGridPos.x, bulletGridPos.y);
             int& bDamage = bullet.getComponent<CDamage>().damage;
 
             if (bDamage >= tile.health)
@@ -2014,14 +2096,15 @@ void ScenePlay::projectileTileCollisions(std::vector<Tile>& tiles, std::vector<E
             }
             else
             {
-                tile.health -= bDamage;
+                tile.health = static_cast<uint8_t>(tile.health - bDamage);
             }
+            m_tileManager.setTile(bulletGridPos.x, bulletGridPos.y, tile);
 
             bDamage /= 2;
 
             if (bDamage <= 0)
             {
-                bullet.destroy();
+                m_entityManager.getCommandBuffer().destroy(bullet.getHandle());
             }
             else if (tile.type == TileType::STONE)
             {
@@ -2097,15 +2180,16 @@ void ScenePlay::projectileTileCollisions(std::vector<Tile>& tiles, std::vector<E
 
 void ScenePlay::projectilePlayerCollisions(std::vector<Entity>& players, std::vector<Entity>& bullets)
 {
+    CommandBuffer& commands = m_entityManager.getCommandBuffer(); // destroyed entities stay in the lists being looped over until the next update
     for (Entity& player : players)
     {
         for (Entity& bullet : bullets)
         {
             int& playerInvincibilityTime = player.getComponent<CInvincibility>().timeRemaining;
-            Vec2f& playerPos = player.getComponent<CTransform>().pos;
-            Vec2f& playerBoxHalfSize = player.getComponent<CBoundingBox>().halfSize;
+            const Vec2f& playerPos = player.readComponent<CTransform>().pos;
+            const Vec2f& playerBoxHalfSize = player.readComponent<CBoundingBox>().halfSize;
 
-            if (playerInvincibilityTime <= 0 && Physics::IsInside(bullet.getComponent<CTransform>().pos, playerPos, playerBoxHalfSize))
+            if (playerInvincibilityTime <= 0 && Physics::IsInside(bullet.readComponent<CTransform>().pos, playerPos, playerBoxHalfSize))
             {
                 playerInvincibilityTime = 10; /// TODO: maybe use another way to keep track of bullets that have already hit the player, make them unable to hit again until leaving the player, could even make no invincibility time and have that be a part of the game, where bullets do more damage the longer they're in the player or a tile, so hitting a leg isn't much compared to hitting a chest (and add a head multiplier), could be a unique aspect to the game
                 int& bulletDamage = bullet.getComponent<CDamage>().damage;
@@ -2115,16 +2199,16 @@ void ScenePlay::projectilePlayerCollisions(std::vector<Entity>& players, std::ve
 
                 if (bulletDamage <= 0)
                 {
-                    bullet.destroy();
+                    commands.destroy(bullet.getHandle());
                 }
 
                 if (playerHealth <= 0)
                 {
                     createRagdoll(player, bullet);
-                    player.destroy();
+                    commands.destroy(player.getHandle());
 
                     createRagdoll(m_weapon, bullet); /// TODO: don't use m_weapon, use something else maybe
-                    m_weapon.destroy();
+                    commands.destroy(m_weapon.getHandle());
                 }
             }
         }
@@ -2132,7 +2216,7 @@ void ScenePlay::projectilePlayerCollisions(std::vector<Entity>& players, std::ve
 }
 
 /// @brief replace entity with ragdoll version created when cause kills entity
-Entity ScenePlay::spawnRagdollElement(const Vec2f& pos, float angle, const Vec2f& boxSize, const Animation& animation)
+Entity ScenePlay::spawnRagdollElement(const Vec2f& pos, float angle, const Vec2f& boxSize, AnimationID animation)
 {
     Entity ragdoll = m_entityManager.addEntity(Entity::Type::RAGDOLL_PART);
     ragdoll.addComponent<CTransform>(pos, angle);
@@ -2146,17 +2230,18 @@ Entity ScenePlay::spawnRagdollElement(const Vec2f& pos, float angle, const Vec2f
 
 void ScenePlay::createRagdoll(const Entity& entity, const Entity& cause)
 {
-    const CTransform& entityTrans = entity.getComponent<CTransform>();
-    const CBoundingBox& entityBox = entity.getComponent<CBoundingBox>();
-    const CAnimation& entityAnim = entity.getComponent<CAnimation>();
-    const CTransform& causeTrans = cause.getComponent<CTransform>();
+    // copies, spawning the parts below can move these entities' components with the archetype pool
+    const CTransform entityTrans = entity.readComponent<CTransform>();
+    const CBoundingBox entityBox = entity.readComponent<CBoundingBox>();
+    const CAnimation entityAnim = entity.readComponent<CAnimation>();
+    const CTransform causeTrans = cause.readComponent<CTransform>();
 
     // weapon
     if (entity.hasComponent<CFire>())
     {
-        Entity ragdoll = spawnRagdollElement(entityTrans.pos, entityTrans.angle, entityBox.size, entityAnim.animation);
+        Entity ragdoll = spawnRagdollElement(entityTrans.pos, entityTrans.angle, entityBox.size, entityAnim.id);
         CTransform& ragTrans = ragdoll.getComponent<CTransform>();
-        CBoundingBox& ragBox = ragdoll.getComponent<CBoundingBox>();
+        const CBoundingBox& ragBox = ragdoll.readComponent<CBoundingBox>();
 
         Vec2f force;
         Vec2f pos;
@@ -2171,7 +2256,7 @@ void ScenePlay::createRagdoll(const Entity& entity, const Entity& cause)
     {
         /// TODO: change to correct animations, angles, and positions, and make sizing dynamic
         // created in order of rendering
-        const Animation& tempTest = m_game.assets().getAnimation("Test");
+        const AnimationID tempTest = m_game.assets().getAnimationID("Test");
         Entity backForearm = spawnRagdollElement(entityTrans.pos, 0.0f, { 6, 12 }, tempTest);
         Entity backUpperArm = spawnRagdollElement(entityTrans.pos, 0.0f, { 6, 12 }, tempTest);
         Entity backCalf = spawnRagdollElement(entityTrans.pos, 0.0f, { 6, 22 }, tempTest);
@@ -2197,42 +2282,42 @@ void ScenePlay::createRagdoll(const Entity& entity, const Entity& cause)
         frontForearm.addComponent<CJointRelation>(frontUpperArm, 0.0f, 5.0f * Constants::pi / 6.0f);
 
         // add joint positions
-        positions[0] = head.getComponent<CBoundingBox>().halfSize.y; // to torso
+        positions[0] = head.readComponent<CBoundingBox>().halfSize.y; // to torso
         head.addComponent<CJointInfo>(positions);
 
-        positions[0] = -backForearm.getComponent<CBoundingBox>().halfSize.y; // to back upper arm
+        positions[0] = -backForearm.readComponent<CBoundingBox>().halfSize.y; // to back upper arm
         backForearm.addComponent<CJointInfo>(positions);
 
-        positions[0] = -frontForearm.getComponent<CBoundingBox>().halfSize.y; // to front upper arm
+        positions[0] = -frontForearm.readComponent<CBoundingBox>().halfSize.y; // to front upper arm
         frontForearm.addComponent<CJointInfo>(positions);
 
-        positions[0] = -backCalf.getComponent<CBoundingBox>().halfSize.y; // to back thigh
+        positions[0] = -backCalf.readComponent<CBoundingBox>().halfSize.y; // to back thigh
         backCalf.addComponent<CJointInfo>(positions);
 
-        positions[0] = -frontCalf.getComponent<CBoundingBox>().halfSize.y; // to front thigh
+        positions[0] = -frontCalf.readComponent<CBoundingBox>().halfSize.y; // to front thigh
         frontCalf.addComponent<CJointInfo>(positions);
 
-        CBoundingBox& ltb = backThigh.getComponent<CBoundingBox>();
+        const CBoundingBox& ltb = backThigh.readComponent<CBoundingBox>();
         positions[0] = ltb.halfSize.y; // to back calf
         positions[1] = -ltb.halfSize.y; // to torso
         backThigh.addComponent<CJointInfo>(positions);
 
-        CBoundingBox& rtb = frontThigh.getComponent<CBoundingBox>();
+        const CBoundingBox& rtb = frontThigh.readComponent<CBoundingBox>();
         positions[0] = rtb.halfSize.y; // to front calf
         positions[1] = -rtb.halfSize.y; // to torso
         frontThigh.addComponent<CJointInfo>(positions);
 
-        CBoundingBox& luab = backUpperArm.getComponent<CBoundingBox>();
+        const CBoundingBox& luab = backUpperArm.readComponent<CBoundingBox>();
         positions[0] = luab.halfSize.y; // to back forearm
         positions[2] = -luab.halfSize.y; // to torso
         backUpperArm.addComponent<CJointInfo>(positions);
 
-        CBoundingBox& ruab = frontUpperArm.getComponent<CBoundingBox>();
+        const CBoundingBox& ruab = frontUpperArm.readComponent<CBoundingBox>();
         positions[0] = ruab.halfSize.y; // to front forearm
         positions[2] = -ruab.halfSize.y; // to torso
         frontUpperArm.addComponent<CJointInfo>(positions);
 
-        CBoundingBox& tb = torso.getComponent<CBoundingBox>();
+        const CBoundingBox& tb = torso.readComponent<CBoundingBox>();
         positions[0] = -tb.halfSize.y; // to head
         positions[1] = tb.halfSize.y * 0.8f; // to thighs
         positions[2] = -tb.halfSize.y * 0.8f; // to upper arms
@@ -2249,7 +2334,7 @@ void ScenePlay::createRagdoll(const Entity& entity, const Entity& cause)
         // }
 
         CTransform& tt = torso.getComponent<CTransform>();
-        Physics::ForceEntity(tt.pos, tt.velocity, tt.angularVelocity, tb.size, causeTrans.velocity * 10.0f * Random::getFloatingPoint(0.5f, 2.0f), causeTrans.pos);
+        Physics::ForceEntity(tt.pos, tt.velocity, tt.angularVelocity, torso.readComponent<CBoundingBox>().size, causeTrans.velocity * 10.0f * Random::getFloatingPoint(0.5f, 2.0f), causeTrans.pos);
     }
 }
 
@@ -2258,11 +2343,10 @@ void ScenePlay::updateProjectiles(std::vector<Entity>& projectiles)
 {
     PROFILE_FUNCTION();
 
+    // movement, projectiles are the entities with both a lifespan and damage, so sweep them straight from the storages
     /// TODO: works for bullets, change when adding more projectile types
-    for (Entity& projectile : projectiles)
+    m_entityManager.view<CTransform, const CLifespan, const CDamage>().each([](EntityID, CTransform& projectileTrans, const CLifespan&, const CDamage&)
     {
-        // movement
-        CTransform& projectileTrans = projectile.getComponent<CTransform>();
         projectileTrans.prevPos = projectileTrans.pos;
         projectileTrans.pos += projectileTrans.velocity;
 
@@ -2288,7 +2372,7 @@ void ScenePlay::updateProjectiles(std::vector<Entity>& projectiles)
         //         }
         //     }
         // }
-    }
+    });
 
     std::vector<Entity>& players = m_entityManager.getEntities(Entity::Type::PLAYER);
 
@@ -2297,318 +2381,215 @@ void ScenePlay::updateProjectiles(std::vector<Entity>& projectiles)
     /// TODO: be more ECS-like, put all manip of CTrans in the sMovement system or something
 
     // check for collisions with tiles
-    std::vector<Tile>& tiles = m_tileManager.getTiles();
-    projectileTileCollisions(tiles, projectiles);
+    projectileTileCollisions(projectiles);
     projectilePlayerCollisions(players, projectiles);
 }
 
-/// @brief find tile grid coords that are reachable from (x, y) grid coords without breaking other tiles and add them to openTiles
-/// TODO: way to only update visible tiles on certain events like destroy tile, move, place tile, etc.?
-void ScenePlay::findOpenTiles(int x, int y, int minX, int maxX, int minY, int maxY, const std::vector<Tile>& tiles, std::vector<Vec2i>& openTiles, std::vector<Vec2i>& tileStack, std::vector<char>& visited)
+/// @brief time the visibility flood fill over fully open areas, its worst case since every cell in the bounds gets filled, and print the results
+void ScenePlay::benchmarkFloodFill()
 {
-    // base case - off game world or rendering screen
-    /// TODO: seg fault on world edge case, just make world bounds so that camera always in middle and player never reaches "edge"
-    if (x < minX || y < minY || x > maxX || y > maxY)
-    {
-        return;
-    }
+    PROFILE_FUNCTION();
 
-    // base case - active tile found
-    const Tile& tile = tiles.data()[x * m_worldMaxCells.y + y];
-    if (tile.blocksVision)
-    {
-        openTiles.emplace_back(x, y);
-        return;
-    }
+    const TileBitset open(m_worldMaxCells.x, m_worldMaxCells.y);
+    FloodFill floodFill; // separate from m_floodFill so this frame's visible tiles are untouched
+    const Vec2i start { m_worldMaxCells.x / 2, m_worldMaxCells.y / 2 };
+    constexpr int iterations = 100;
 
-    // recursive step - add all neighbors and call function on next tile
-    if (x < maxX && !visited.data()[(x - minX + 1) * (maxY - minY + 1) + (y - minY)])
-    {
-        tileStack.emplace_back(x + 1, y);
-        visited.data()[(x - minX + 1) * (maxY - minY + 1) + (y - minY)] = true;
-    }
-    if (y > minY && !visited.data()[(x - minX) * (maxY - minY + 1) + (y - minY - 1)])
-    {
-        tileStack.emplace_back(x, y - 1);
-        visited.data()[(x - minX) * (maxY - minY + 1) + (y - minY - 1)] = true;
-    }
-    if (x > minX && !visited.data()[(x - minX - 1) * (maxY - minY + 1) + (y - minY)])
+    for (const int halfSize : { 64, 128, 256, 512 })
     {
-        tileStack.emplace_back(x - 1, y);
-        visited.data()[(x - minX - 1) * (maxY - minY + 1) + (y - minY)] = true;
-    }
-    if (y < maxY && !visited.data()[(x - minX) * (maxY - minY + 1) + (y - minY + 1)])
-    {
-        tileStack.emplace_back(x, y + 1);
-        visited.data()[(x - minX) * (maxY - minY + 1) + (y - minY + 1)] = true;
-    }
+        const int minX = std::max(0, start.x - halfSize);
+        const int maxX = std::min(m_worldMaxCells.x - 1, start.x + halfSize);
+        const int minY = std::max(0, start.y - halfSize);
+        const int maxY = std::min(m_worldMaxCells.y - 1, start.y + halfSize);
 
-    while (!tileStack.empty())
-    {
-        Vec2i topVal = tileStack.back();
-        tileStack.pop_back();
-        findOpenTiles(topVal.x, topVal.y, minX, maxX, minY, maxY, tiles, openTiles, tileStack, visited);
+        floodFill.run(open, start, minX, maxX, minY, maxY); // first run sizes the buffers
+
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            floodFill.run(open, start, minX, maxX, minY, maxY);
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+        std::cout << "flood fill " << maxX - minX + 1 << "x" << maxY - minY + 1 << " open cells: "
+            << static_cast<double>(elapsed.count()) / iterations << " us per fill\n";
     }
 }
 
-std::vector<Vec2f> ScenePlay::rayCast(const Vec2f& viewCenter, const Vec2f& viewSize, const std::vector<Vec2i>& openTiles, const Vec2f& origin, const std::vector<Tile>& tiles, int minX, int maxX, int minY, int maxY)
+/// @brief fill pool with entities shaped like bullets and ragdoll parts, then time the sweeps the game's systems do over them
+/// @param bulletShare fraction of the entities that are bullets, the rest are ragdoll parts
+template <typename Pool>
+static void benchmarkEntityPool(const char* name, const char* scene, EntityID count, float bulletShare, AnimationID animation)
 {
-    PROFILE_FUNCTION();
-
-    // use open-air tiles with ray casting
-    std::vector<Vec2f> vertices; // in pixels
-    std::unordered_set<Vec2f> vertexSet; // use unordered set to collect unique vertices and put only unique ones in vector
-
-    // four corners of the screen
-    /// TODO: see if the + 1 is necessary now that they're floats
-    vertices.emplace_back(viewCenter.x - viewSize.x / 2.0f, viewCenter.y - viewSize.y / 2.0f);
-    vertices.emplace_back(viewCenter.x + viewSize.x / 2.0f, viewCenter.y - viewSize.y / 2.0f);
-    vertices.emplace_back(viewCenter.x - viewSize.x / 2.0f, viewCenter.y + viewSize.y / 2.0f); /// TODO: these may not be necessary of players will never reach bottom of world
-    vertices.emplace_back(viewCenter.x + viewSize.x / 2.0f, viewCenter.y + viewSize.y / 2.0f); /// TODO: these may not be necessary of players will never reach bottom of world
-
-    // add open tile corners
-    for (const Vec2i& tileCoords : openTiles)
+    Pool pool(count);
+    const EntityID bullets = static_cast<EntityID>(static_cast<float>(count) * bulletShare);
+    EntityHandle previous;
+    for (EntityID i = 0; i < count; ++i)
     {
-        Vec2i corners[4] = { tileCoords,
-                           { tileCoords.x, tileCoords.y + 1 },
-                           { tileCoords.x + 1, tileCoords.y },
-                           { tileCoords.x + 1, tileCoords.y + 1 } };
-
-        for (const Vec2i& v : corners)
+        const EntityID id = pool.addEntity();
+        const Vec2f pos { static_cast<float>(i % 1000), static_cast<float>(i / 1000) };
+        if (i < bullets)
         {
-            if (vertexSet.insert((v * m_cellSizePixels).to<float>()).second) // insert() returns {iterator, bool}, bool is true if inserted
+            pool.template addComponent<CTransform>(id, pos, Vec2f(4.0f, 0.0f), Vec2f(2.0f, 2.0f), 0.0f, 0.0f);
+            pool.template addComponent<CBoundingBox>(id, Vec2f(2.0f, 2.0f));
+            pool.template addComponent<CAnimation>(id, animation, false);
+            pool.template addComponent<CLifespan>(id, 300);
+            pool.template addComponent<CDamage>(id, 10);
+        }
+        else
+        {
+            pool.template addComponent<CTransform>(id, pos, 0.0f);
+            pool.template addComponent<CGravity>(id, 0.2f);
+            pool.template addComponent<CBoundingBox>(id, Vec2f(4.0f, 8.0f));
+            pool.template addComponent<CAnimation>(id, animation, false);
+            pool.template addComponent<CLifespan>(id, 600);
+            if (i % 10 != 0) // every part but the torso hangs off another
             {
-                vertices.push_back((v * m_cellSizePixels).to<float>());
+                pool.template addComponent<CJointRelation>(id, previous, -1.0f, 1.0f);
+                pool.template addComponent<CJointInfo>(id, std::array<float, 3> { 0.0f, 0.5f, 1.0f });
             }
         }
+        previous = { id, pool.getGeneration(id) };
     }
 
-    // filter visible vertices and add new points behind them
-    std::vector<Vec2f> verticesToAdd;
-    for (size_t i = 0; i < vertices.size(); ++i)
-    {
-        Vec2f& vertex = vertices[i];
-        float rayAngle = (vertex - origin).angle();
+    constexpr int iterations = 100;
+    float checksum = 0.0f; // printed so the sweeps can't be optimized out
 
-        /// for this method: if it's middle ray and reaches vertex, remove it; if it's side ray, let it go until it hits something and add a vertex there
-        // for (int dTheta = -1; dTheta < 2; ++dTheta)
-        // {
-            // float angle = rayAngle + dTheta * 0.0001f;
-        float angle = rayAngle;
-        Vec2f rayUnitVec(cosf(angle), sinf(angle));
-        float slope = tanf(angle);
-        float reciprocalSlope = 1.0f / slope;
-        float xMoveHypDist = sqrtf(1 + slope * slope); // in grid coords
-        float yMoveHypDist = sqrtf(1 + reciprocalSlope * reciprocalSlope); // in grid coords
-
-        // coordinates of grid cell the traveling ray is in
-        /// TODO: test edge cases: if hitting right side of tile, I want this coord to truncate to the left side of the tile (since tiles positioned with top-left), this could be wrong, subtly
-        Vec2i gridCoord = origin.to<int>() / m_cellSizePixels;
-
-        // way we step in x or y when traveling the ray
-        Vec2i rayStep;
-
-        // accumulated distances (pixels) in the direction of the hypoteneuse caused by a change in x/y from the start of the ray (player position), starting with initial pixel offset from grid coord (top-left)
-        float xTravel, yTravel;
+    auto begin = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; ++n)
+    {
+        pool.template view<CTransform, const CLifespan>().each([&](EntityID, CTransform& trans, const CLifespan& lifespan)
+            {
+                trans.pos += trans.velocity;
+                checksum += static_cast<float>(lifespan.lifespan);
+            });
+    }
+    const auto lifespanSweep = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
 
-        if (rayUnitVec.x < 0)
-        {
-            rayStep.x = -1;
-            xTravel = (origin.x - (gridCoord.x * m_cellSizePixels)) * xMoveHypDist;
-        }
-        else
-        {
-            rayStep.x = 1;
-            xTravel = (m_cellSizePixels - (origin.x - (gridCoord.x * m_cellSizePixels))) * xMoveHypDist;
-        }
+    begin = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; ++n)
+    {
+        pool.template view<CTransform, const CGravity, const CBoundingBox>().each([&](EntityID, CTransform& trans, const CGravity& gravity, const CBoundingBox& box)
+            {
+                trans.velocity.y += gravity.gravity;
+                checksum += box.halfSize.y;
+            });
+    }
+    const auto gravitySweep = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
 
-        if (rayUnitVec.y < 0)
-        {
-            rayStep.y = -1;
-            yTravel = (origin.y - (gridCoord.y * m_cellSizePixels)) * yMoveHypDist;
-        }
-        else
+    begin = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; ++n)
+    {
+        for (EntityID id = 0; id < count; ++id)
         {
-            rayStep.y = 1;
-            yTravel = (m_cellSizePixels - (origin.y - (gridCoord.y * m_cellSizePixels))) * yMoveHypDist;
+            checksum += pool.template readComponent<CTransform>(id).pos.x;
         }
+    }
+    const auto lookups = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
 
-        bool tileHit = false;
-        bool vertexReached = false;
-        // bool topLeft, topRight, bottomLeft, bottomRight;
-        while (!tileHit && !vertexReached) /// TODO: alternatively, add a xTravel < rayLength - 0.001f or something instead of vertexReached
-        {
-            if (xTravel < yTravel)
-            {
-                gridCoord.x += rayStep.x;
+    std::cout << name << ", " << scene << " (" << count << " entities): "
+        << static_cast<double>(lifespanSweep.count()) / iterations << " us transform+lifespan sweep, "
+        << static_cast<double>(gravitySweep.count()) / iterations << " us transform+gravity+box sweep, "
+        << static_cast<double>(lookups.count()) / iterations << " us transform lookups by ID"
+        << " (checksum " << checksum << ")\n";
+}
 
-                // at this point, the endpoint of the line formed by origin + xTravel * rayUnitVec is the collision point on tile (gridCoord.x, gridCoord.y) if tile is active there
+/// @brief compare the component-array pool with the archetype pool on bullet-heavy and ragdoll-heavy scenes, and print the results
+void ScenePlay::benchmarkEntityPools()
+{
+    PROFILE_FUNCTION();
 
-                xTravel += xMoveHypDist * m_cellSizePixels;
-            }
-            else
-            {
-                gridCoord.y += rayStep.y;
-                yTravel += yMoveHypDist * m_cellSizePixels;
-            }
+    constexpr EntityID count = 20000;
 
-            const Tile& tile = tiles.data()[gridCoord.x * m_worldMaxCells.y + gridCoord.y];
-            if (tile.blocksVision) // tile hit /// TODO: seg fault on edges of world or if second check fails and this goes on
-            {
-                tileHit = true;
+    for (const auto& [scene, bulletShare] : { std::pair { "bullet-heavy", 0.9f }, std::pair { "ragdoll-heavy", 0.1f } })
+    {
+        benchmarkEntityPool<EntityMemoryPool>("component arrays", scene, count, bulletShare, m_bulletAnimation);
+        benchmarkEntityPool<ArchetypePool>("archetypes", scene, count, bulletShare, m_bulletAnimation);
+    }
+}
 
-                // remove vertex from vertices
-                vertex = vertices.back();
-                vertices.pop_back();
-                --i;
-            }
+/// @brief simulate the state traffic of lobbies of several sizes, every player sending its position and velocity each tick and the lobby relaying them to everyone else, and print bytes per player per second for the old raw format and the packed one
+void ScenePlay::benchmarkNetworkBandwidth()
+{
+    PROFILE_FUNCTION();
 
-            // if vertex reached and not originally unique (another tile shares it so don't go through) just keep vertex point, do nothing
-            /// TODO: keep repeats? given this thought above ^
-            if (!tile.blocksVision && (vertex.x >= gridCoord.x * m_cellSizePixels && vertex.x <= (gridCoord.x + 1) * m_cellSizePixels && vertex.y >= gridCoord.y * m_cellSizePixels && vertex.y <= (gridCoord.y + 1) * m_cellSizePixels)) // vertex reached since in cell with no tile but with this vertex
-            {
-                vertexReached = true;
-            }
-        }
-        // }
+    constexpr size_t rawHeaderSize = sizeof(NetworkBatch::Sequence) + sizeof(uint16_t); // sequence and count, then every datum memcpy'd whole
+    constexpr int ticks = 100;
+    const float worldMaxX = static_cast<float>(m_worldMaxCells.x * Settings::cellSizePixels);
+    const float worldMaxY = static_cast<float>(m_worldMaxCells.y * Settings::cellSizePixels);
 
-        /// find vertex and divert angle method, less rays, but possibly still more work
-        /// @todo try the 3 ray method since branch prediction would be better without all the if's
-        // note that the top two corners of the screen are reached as well as actual vertices
-        if (vertexReached)
+    for (const EntityID players : { 2u, 8u, 32u })
+    {
+        std::vector<NetworkDatum> state; // each player's position and velocity for one tick
+        for (EntityID id = 0; id < players; ++id)
         {
-            /// if vertex reached and if just passed there is no tile, expand line to next intersection or end of screen and create new point there for triangle fan
+            NetworkDatum& position = state.emplace_back();
+            position.dataType = NetworkDatum::DataType::POSITION;
+            position.first.id = id;
+            position.second.f = Random::getFloatingPoint(0.0f, worldMaxX);
+            position.third.f = Random::getFloatingPoint(0.0f, worldMaxY);
+
+            NetworkDatum& velocity = state.emplace_back();
+            velocity.dataType = NetworkDatum::DataType::VELOCITY;
+            velocity.first.id = id;
+            velocity.second.f = Random::getFloatingPoint(-10.0f, 10.0f);
+            velocity.third.f = Random::getFloatingPoint(-10.0f, 10.0f);
+        }
 
-            // check for tile just passed the vertex in the direction of the ray
-            Vec2i checkCoord = ((vertex + rayUnitVec) / m_cellSizePixels).to<int>();
+        NetworkBatch batch;
+        size_t rawBytes = 0;
+        size_t packedBytes = 0;
+        float maxError = 0.0f;
+        std::vector<NetworkDatum> received;
 
-            const Tile& tile = tiles.data()[checkCoord.x * m_worldMaxCells.y + checkCoord.y];
-            if (!(checkCoord.x < minX || checkCoord.x > maxX ||
-                checkCoord.y < minY || checkCoord.y > maxY || tile.blocksVision))
+        const auto begin = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            for (EntityID player = 0; player < players; ++player)
             {
-                /// add small angle to ray
-                /// NOTE: angle starts at 0 on +x-axis and increases in a CW manner up to 2π (since +y-axis points down)
-                /// TODO: is this more expensive than just adding two more rays at slight angle offsets for each ray?
-                /// TODO: handle pure vertical and horizontal rays case
-
-                float dTheta = 0.0001f;
-                float newAngle;
-
-                if (rayUnitVec.x < 0 && rayUnitVec.y < 0) // came from bottom right
-                {
-                    /// @todo ensure gridCoord > (0, 0)
-                    if (tiles.data()[(gridCoord.x - 1) * m_worldMaxCells.y + gridCoord.y].blocksVision &&
-                        tiles.data()[gridCoord.x * m_worldMaxCells.y + gridCoord.y - 1].blocksVision) // shared vertex
-                        continue; // don't want ray shining through diagonal lines of tiles
-
-                    if (tiles.data()[(gridCoord.x - 1) * m_worldMaxCells.y + gridCoord.y].blocksVision) // tile to the left active
-                        newAngle = rayAngle + dTheta; // CW
-                    else // tile above active
-                        newAngle = rayAngle - dTheta; // CCW
-                }
-                else if (rayUnitVec.x > 0.0f && rayUnitVec.y < 0.0f) // came from bottom left
-                {
-                    if (tiles.data()[gridCoord.x * m_worldMaxCells.y + (gridCoord.y - 1)].blocksVision &&
-                        tiles.data()[(gridCoord.x + 1) * m_worldMaxCells.y + gridCoord.y].blocksVision)
-                        continue;
-
-                    if (tiles.data()[gridCoord.x * m_worldMaxCells.y + (gridCoord.y - 1)].blocksVision) // tile above active
-                        newAngle = rayAngle + dTheta; // CW
-                    else // tile to the right active
-                        newAngle = rayAngle - dTheta;; // CCW
-                }
-                else if (rayUnitVec.x > 0 && rayUnitVec.y > 0) // came from top left
-                {
-                    if (tiles.data()[(gridCoord.x + 1) * m_worldMaxCells.y + gridCoord.y].blocksVision &&
-                        tiles.data()[gridCoord.x * m_worldMaxCells.y + (gridCoord.y + 1)].blocksVision)
-                        continue;
-
-                    if (tiles.data()[(gridCoord.x + 1) * m_worldMaxCells.y + gridCoord.y].blocksVision) // tile to the right
-                        newAngle = rayAngle + dTheta; // CW
-                    else // tile below is active
-                        newAngle = rayAngle - dTheta; // CCW
-                }
-                else // came from top right or /// TODO: a horizontal/vertical ray case
+                // upstream, the player's own state
+                batch.add(state[player * 2]);
+                batch.add(state[player * 2 + 1]);
+                batch.encode(static_cast<NetworkBatch::Sequence>(tick));
+                rawBytes += rawHeaderSize + batch.getCount() * sizeof(NetworkDatum);
+                packedBytes += batch.size();
+                batch.clear();
+
+                // downstream, everyone else's state relayed by the lobby
+                for (EntityID other = 0; other < players; ++other)
                 {
-                    if (tiles.data()[gridCoord.x * m_worldMaxCells.y + (gridCoord.y + 1)].blocksVision &&
-                        tiles.data()[(gridCoord.x - 1) * m_worldMaxCells.y + gridCoord.y].blocksVision)
-                        continue;
-
-                    if (tiles.data()[gridCoord.x * m_worldMaxCells.y + (gridCoord.y + 1)].blocksVision) // tile below is active
-                        newAngle = rayAngle + dTheta; // CW
-                    else // tile to the left is active
-                        newAngle = rayAngle - dTheta; // CCW
+                    if (other != player)
+                    {
+                        batch.add(state[other * 2]);
+                        batch.add(state[other * 2 + 1]);
+                    }
                 }
+                batch.encode(static_cast<NetworkBatch::Sequence>(tick));
+                rawBytes += rawHeaderSize + batch.getCount() * sizeof(NetworkDatum);
+                packedBytes += batch.size();
 
-                Vec2f newRayUnitVec = { cosf(newAngle), sinf(newAngle) };
-                slope = tanf(newAngle);
-                reciprocalSlope = 1.0f / slope;
-                xMoveHypDist = sqrtf(1 + slope * slope);
-                yMoveHypDist = sqrtf(1 + reciprocalSlope * reciprocalSlope);
-
-                float xTravelNew = xMoveHypDist * m_cellSizePixels;
-                float yTravelNew = yMoveHypDist * m_cellSizePixels;
-                gridCoord = checkCoord.to<int>();
-
-                while (!tileHit)
+                if (tick == 0 && player == 0) // check what a receiver gets back once
                 {
-                    if (xTravelNew < yTravelNew)
-                    {
-                        gridCoord.x += rayStep.x;
-
-                        // at this point, the endpoint of the line formed by vertex + xTravelNew * newRayUnitVec is the collision point on tile (gridCoord.x, gridCoord.y) if tile is active there
-
-                        if (gridCoord.x < minX || gridCoord.x > maxX ||
-                            tiles.data()[gridCoord.x * m_worldMaxCells.y + gridCoord.y].blocksVision)
-                        {
-                            tileHit = true;
-                            verticesToAdd.push_back(vertex + newRayUnitVec * xTravelNew);
-                        }
-                        else
-                        {
-                            xTravelNew += xMoveHypDist * m_cellSizePixels;
-                        }
-                    }
-                    else
+                    received.clear();
+                    NetworkBatch::unpack(batch.data(), batch.size(), received);
+                    for (size_t i = 0; i < received.size(); i += 2)
                     {
-                        gridCoord.y += rayStep.y;
-
-                        if (gridCoord.y < minY || gridCoord.y > maxY ||
-                            tiles.data()[gridCoord.x * m_worldMaxCells.y + gridCoord.y].blocksVision)
-                        {
-                            tileHit = true;
-                            verticesToAdd.push_back(vertex + newRayUnitVec * yTravelNew);
-                        }
-                        else
-                        {
-                            yTravelNew += yMoveHypDist * m_cellSizePixels;
-                        }
+                        const NetworkDatum& sent = state[(i / 2 + 1) * 2];
+                        maxError = std::max({ maxError, std::abs(received[i].second.f - sent.second.f), std::abs(received[i].third.f - sent.third.f) });
                     }
                 }
+                batch.clear();
             }
         }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+        const double perPlayerPerSecond = static_cast<double>(Settings::frameRate) / (ticks * players);
+        std::cout << "network state, " << players << " players at " << Settings::frameRate << " ticks/s: "
+            << static_cast<double>(rawBytes) * perPlayerPerSecond << " bytes per player per second raw, "
+            << static_cast<double>(packedBytes) * perPlayerPerSecond << " packed, "
+            << static_cast<double>(elapsed.count()) / ticks << " us encoding per tick, "
+            << maxError << " px max position error\n";
     }
-
-    // for (const auto& v : verticesToAdd)
-    // {
-    //     sf::CircleShape dot(2);
-    //     dot.setPosition({ v.x - 2, v.y - 2 });
-    //     dot.setFillColor(sf::Color::Red);
-    //     window.draw(dot);
-    // }
-    vertices.insert(vertices.end(), verticesToAdd.begin(), verticesToAdd.end());
-
-    // sort the reachable vertices by angle
-    /// TODO: consider storing angle for each vertex in the vector, faster probably
-    std::sort(vertices.begin(), vertices.end(), [&origin](const Vec2f& a, const Vec2f& b) { return (origin - a).angle() < (origin - b).angle(); });
-
-    // create triangle fan of vertices (pixels)
-    std::vector<Vec2f> triangleFan;
-    triangleFan.push_back(origin);
-    triangleFan.insert(triangleFan.end(), vertices.begin(), vertices.end());
-    triangleFan.push_back(vertices.front());
-
-    return triangleFan;
 }
 
 /// TODO: memory leak or something in this scope causes game to get real slow after about 40 seconds
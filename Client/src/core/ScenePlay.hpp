@@ -6,6 +6,9 @@
 #include "Scene.hpp"
 #include "EntityManager.hpp"
 #include "GameEngine.hpp"
+#include "TileChunkMeshes.hpp"
+#include "TileTexture.hpp"
+#include "MinimapTexture.hpp"
 
 // Physics
 #include "physics/Vec2.hpp"
@@ -15,6 +18,8 @@
 
 // World
 #include "world/TileManager.hpp"
+#include "world/FloodFill.hpp"
+#include "world/VisibilityPolygon.hpp"
 
 // External libraries
 #include <SFML/Graphics.hpp>
@@ -22,6 +27,7 @@
 // C++ standard libraries
 #include <string>
 #include <chrono>
+#include <array>
 
 class ScenePlay : public Scene
 {
@@ -48,17 +54,47 @@ protected:
     sf::View m_miniMapView = sf::View({ 0.0f, 0.0f }, sf::Vector2f(m_worldMaxCells.x, m_worldMaxCells.y) * 2.0f); // center, size
 
     // Entities
-    EntityManager m_entityManager;
+    EntityWorld m_world { Settings::worldMaxEntities }; // this scene's entities and components, declared before the manager that uses it
+    EntityManager m_entityManager { m_world };
     Entity m_player, m_weapon; // commonly used
     Entity m_head, m_torso, m_leftUpperArm, m_leftForearm, m_rightUpperArm, m_rightForearm, m_leftHandBack, m_leftHandFront, m_rightHandBack, m_rightHandFront, m_leftThigh, m_rightThigh, m_leftCalf, m_rightCalf, m_leftFoot, m_rightFoot; // body parts
     PlayerConfig m_playerConfig;
+    AnimationID m_bulletAnimation = 0; // m_playerConfig.BA, looked up once so spawning a bullet doesn't search by name
 
     // Tiles
     TileManager m_tileManager;
+    FloodFill m_floodFill; // open area around the player, reused every frame
+
+    // Visibility cache, the open area is refilled only when the player changes cell, the view bounds change, or tiles change
+    Vec2i m_visibilityCell { -1, -1 };
+    std::array<int, 4> m_visibilityBounds {}; // minX, maxX, minY, maxY
+    uint64_t m_visibilityGeneration = 0; // tile edit generation the cache includes
+    sf::VertexArray m_visibleBlocks { sf::PrimitiveType::Triangles };
+    sf::VertexArray m_visibilityFan { sf::PrimitiveType::TriangleFan };
+    Vec2f m_fanOrigin { -1.0f, -1.0f };
+    std::vector<EdgeSegment> m_visionSegments; // vision edges of the chunks in view
+    VisibilityPolygon m_visibilityPolygon; // ray and fan buffers reused between rebuilds
+
+    // Tile meshes stay on the GPU per chunk, the tile shader masks them to the visible cells
+    enum class TileRenderMode
+    {
+        VERTICES, // visible tiles rebuilt into m_visibleBlocks whenever they change
+        CHUNK_MESHES, // per-chunk vertex buffers masked by the tile shader
+        TEXTURE // one texel per visible tile, scaled up
+    };
+    TileRenderMode m_tileRenderMode = TileRenderMode::TEXTURE;
+    TileChunkMeshes m_tileMeshes { m_worldMaxCells.x, m_worldMaxCells.y, m_cellSizePixels };
+    TileTexture m_tileTexture { m_cellSizePixels };
+    sf::Shader m_tileShader;
+    bool m_tileShaderLoaded = false; // without shaders or vertex buffers, CHUNK_MESHES is skipped
+    sf::Texture m_visibilityMask; // one texel per cell in the visibility bounds, white if the cell was reached by the fill
+    std::vector<uint8_t> m_visibilityMaskPixels;
+    MinimapTexture m_minimap { m_worldMaxCells.x, m_worldMaxCells.y }; // whole world, shared by the minimap and the world map
 
     // Rendering
     bool m_drawTextures = true;
     bool m_drawMinimap = true;
+    bool m_drawWorldMap = false;
     bool m_drawCollision = false;
 
     // FPS counter
@@ -72,14 +108,15 @@ protected:
     void spawnPlayer();
     void spawnBullet(Entity entity);
     void updateProjectiles(std::vector<Entity>& bullets);
-    void playerTileCollisions(const std::vector<Tile>& tiles);
-    void projectileTileCollisions(std::vector<Tile>& tiles, std::vector<Entity>& bullets);
+    void playerTileCollisions();
+    void projectileTileCollisions(std::vector<Entity>& bullets);
     void projectilePlayerCollisions(std::vector<Entity>& players, std::vector<Entity>& bullets);
-    Entity spawnRagdollElement(const Vec2f& pos, float angle, const Vec2f& boxSize, const Animation& animation);
+    Entity spawnRagdollElement(const Vec2f& pos, float angle, const Vec2f& boxSize, AnimationID animation);
     void createRagdoll(const Entity& entity, const Entity& cause);
     Vec2f gridToMidPixel(float gridX, float gridY, Entity entity);
-    void findOpenTiles(int x, int y, int minX, int maxX, int minY, int maxY, const std::vector<Tile>& tiles, std::vector<Vec2i>& openTiles, std::vector<Vec2i>& tileStack, std::vector<char>& visited);
-    std::vector<Vec2f> rayCast(const Vec2f& viewCenter, const Vec2f& viewSize, const std::vector<Vec2i>& openTiles, const Vec2f& origin, const std::vector<Tile>& tiles, int minX, int maxX, int minY, int maxY);
+    void benchmarkFloodFill();
+    void benchmarkEntityPools();
+    void benchmarkNetworkBandwidth();
     // void propagateLight(sf::VertexArray& blocks, int maxDepth, int currentDepth, const Vec2i& startCoord, Vec2i currentCoord, int minX, int maxX, int minY, int maxY);
     void addBlock(sf::VertexArray& blocks, int xGrid, int yGrid, const sf::Color& c);
 
@@ -98,6 +135,7 @@ protected:
     void sAnimation(); // entity: animation
     void sAI(); //
     void sCamera(); // entity: transform
+    void sStreaming(); // entity: transform; tile: chunk residency
     void sRender() override; // entity: animation, transform; tile: color
 
 };
@@ -0,0 +1,229 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "world/TileManager.hpp"
+
+// External libraries
+#include <SFML/Graphics.hpp>
+
+// C++ standard libraries
+#include <vector>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+/// @brief one static vertex buffer per 64x64 tile chunk, built the first time the chunk comes into view and patched cell by cell from the TileManager edit log
+/// @note every cell owns a fixed run of 6 vertices (empty cells are collapsed to a point), so a tile edit uploads 6 vertices instead of the whole chunk
+/// meshes of chunks that leave the view are released, so GPU memory scales with the view size and not the world size
+class TileChunkMeshes
+{
+public:
+
+    static constexpr int chunkSize = TileManager::chunkSize;
+    static constexpr int chunkShift = TileManager::chunkShift;
+    static constexpr int verticesPerCell = 6;
+    static constexpr int keepDistanceChunks = 1; // meshes this many chunks outside the view are kept, so walking back and forth doesn't rebuild them
+
+    TileChunkMeshes(int cellsX, int cellsY, int cellSizePixels)
+        : m_cellsX(cellsX)
+        , m_cellsY(cellsY)
+        , m_chunksX((cellsX + chunkSize - 1) >> chunkShift)
+        , m_chunksY((cellsY + chunkSize - 1) >> chunkShift)
+        , m_cellSize(static_cast<float>(cellSizePixels))
+        , m_meshes(static_cast<size_t>(m_chunksX * m_chunksY))
+    { }
+
+    /// @brief apply the tile edits made since the last update, release meshes far outside the inclusive cell rectangle, and build the ones overlapping it
+    void update(TileManager& tiles, int minX, int maxX, int minY, int maxY)
+    {
+        std::span<const TileEdit> edits;
+        if (tiles.getEditsSince(m_generation, edits))
+        {
+            for (const TileEdit& edit : edits)
+            {
+                Mesh& mesh = m_meshes[chunkIndex(edit.cell.x >> chunkShift, edit.cell.y >> chunkShift)];
+                if (mesh.built)
+                {
+                    patchCell(tiles, mesh, edit.cell.x, edit.cell.y);
+                }
+            }
+        }
+        else
+        {
+            // edits were dropped (or a new world was loaded), every mesh is stale
+            for (size_t index : m_builtChunks)
+            {
+                release(m_meshes[index]);
+            }
+            m_builtChunks.clear();
+        }
+        m_generation = tiles.getEditGeneration();
+
+        const int cMinX = std::max(0, minX >> chunkShift);
+        const int cMaxX = std::min(m_chunksX - 1, maxX >> chunkShift);
+        const int cMinY = std::max(0, minY >> chunkShift);
+        const int cMaxY = std::min(m_chunksY - 1, maxY >> chunkShift);
+
+        for (size_t i = 0; i < m_builtChunks.size();)
+        {
+            const size_t index = m_builtChunks[i];
+            const int cx = static_cast<int>(index) % m_chunksX;
+            const int cy = static_cast<int>(index) / m_chunksX;
+            if (cx >= cMinX - keepDistanceChunks && cx <= cMaxX + keepDistanceChunks && cy >= cMinY - keepDistanceChunks && cy <= cMaxY + keepDistanceChunks)
+            {
+                ++i;
+                continue;
+            }
+
+            release(m_meshes[index]);
+            m_builtChunks[i] = m_builtChunks.back();
+            m_builtChunks.pop_back();
+        }
+
+        for (int cy = cMinY; cy <= cMaxY; ++cy)
+        {
+            for (int cx = cMinX; cx <= cMaxX; ++cx)
+            {
+                Mesh& mesh = m_meshes[chunkIndex(cx, cy)];
+                if (!mesh.built)
+                {
+                    build(tiles, mesh, cx, cy);
+                    m_builtChunks.push_back(chunkIndex(cx, cy));
+                }
+            }
+        }
+    }
+
+    /// @brief draw the meshes of the chunks overlapping the inclusive cell rectangle, update must have been called with it first
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states, int minX, int maxX, int minY, int maxY) const
+    {
+        for (int cy = std::max(0, minY >> chunkShift); cy <= std::min(m_chunksY - 1, maxY >> chunkShift); ++cy)
+        {
+            for (int cx = std::max(0, minX >> chunkShift); cx <= std::min(m_chunksX - 1, maxX >> chunkShift); ++cx)
+            {
+                const Mesh& mesh = m_meshes[chunkIndex(cx, cy)];
+                if (mesh.built && mesh.filledCount > 0)
+                {
+                    target.draw(mesh.buffer, states);
+                }
+            }
+        }
+    }
+
+    size_t getBuiltChunkCount() const
+    {
+        return m_builtChunks.size();
+    }
+
+private:
+
+    struct Mesh
+    {
+        sf::VertexBuffer buffer { sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static };
+        std::vector<uint8_t> filled; // per cell, row-major in the chunk, so edits keep filledCount right
+        int filledCount = 0; // chunks of only air aren't drawn
+        bool built = false;
+    };
+
+    int m_cellsX;
+    int m_cellsY;
+    int m_chunksX;
+    int m_chunksY;
+    float m_cellSize;
+    std::vector<Mesh> m_meshes; // chunk (cx, cy) at cy * m_chunksX + cx
+    std::vector<size_t> m_builtChunks;
+    std::vector<sf::Vertex> m_vertices; // staging for a whole chunk, reused between builds
+    uint64_t m_generation = 0; // tile edit generation the meshes include
+
+    size_t chunkIndex(int cx, int cy) const
+    {
+        return static_cast<size_t>(cy * m_chunksX + cx);
+    }
+
+    static size_t localIndex(int x, int y)
+    {
+        return static_cast<size_t>(((y & (chunkSize - 1)) << chunkShift) + (x & (chunkSize - 1)));
+    }
+
+    /// @brief the two triangles of cell (x, y), or 6 copies of its corner if it's empty
+    void writeCell(sf::Vertex* vertices, int x, int y, TileType type) const
+    {
+        const float px = static_cast<float>(x) * m_cellSize;
+        const float py = static_cast<float>(y) * m_cellSize;
+
+        if (type == TileType::NONE)
+        {
+            std::fill(vertices, vertices + verticesPerCell, sf::Vertex { { px, py }, sf::Color::Transparent });
+            return;
+        }
+
+        const TileColor color = TileManager::getColor(type, x, y);
+        const sf::Color c { color.r, color.g, color.b, 255 };
+        vertices[0] = { { px, py }, c };
+        vertices[1] = { { px + m_cellSize, py }, c };
+        vertices[2] = { { px, py + m_cellSize }, c };
+        vertices[3] = { { px, py + m_cellSize }, c };
+        vertices[4] = { { px + m_cellSize, py }, c };
+        vertices[5] = { { px + m_cellSize, py + m_cellSize }, c };
+    }
+
+    void build(TileManager& tiles, Mesh& mesh, int cx, int cy)
+    {
+        const int x0 = cx << chunkShift;
+        const int y0 = cy << chunkShift;
+        const int xEnd = std::min(x0 + chunkSize, m_cellsX);
+        const int yEnd = std::min(y0 + chunkSize, m_cellsY);
+
+        // cells past the world edge keep default vertices, all at the origin, which draw nothing
+        m_vertices.assign(static_cast<size_t>(chunkSize * chunkSize * verticesPerCell), sf::Vertex {});
+        mesh.filled.assign(static_cast<size_t>(chunkSize * chunkSize), 0);
+        mesh.filledCount = 0;
+
+        for (int y = y0; y < yEnd; ++y)
+        {
+            for (int x = x0; x < xEnd; ++x)
+            {
+                const TileType type = tiles.getType(x, y);
+                writeCell(&m_vertices[localIndex(x, y) * verticesPerCell], x, y, type);
+                if (type != TileType::NONE)
+                {
+                    mesh.filled[localIndex(x, y)] = 1;
+                    ++mesh.filledCount;
+                }
+            }
+        }
+
+        if (!mesh.buffer.create(m_vertices.size()) || !mesh.buffer.update(m_vertices.data()))
+        {
+            std::cerr << "Could not upload the mesh of tile chunk (" << cx << ", " << cy << ")\n";
+            exit(-1);
+        }
+        mesh.built = true;
+    }
+
+    void patchCell(TileManager& tiles, Mesh& mesh, int x, int y)
+    {
+        const TileType type = tiles.getType(x, y);
+        const size_t local = localIndex(x, y);
+        const uint8_t filled = type != TileType::NONE;
+        mesh.filledCount += filled - mesh.filled[local];
+        mesh.filled[local] = filled;
+
+        std::array<sf::Vertex, verticesPerCell> vertices;
+        writeCell(vertices.data(), x, y, type);
+        if (!mesh.buffer.update(vertices.data(), verticesPerCell, static_cast<unsigned int>(local * verticesPerCell)))
+        {
+            std::cerr << "Could not update the mesh of tile (" << x << ", " << y << ")\n";
+            exit(-1);
+        }
+    }
+
+    static void release(Mesh& mesh)
+    {
+        mesh = Mesh();
+    }
+};
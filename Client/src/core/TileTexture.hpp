@@ -0,0 +1,114 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "world/TileManager.hpp"
+#include "world/FloodFill.hpp"
+
+// External libraries
+#include <SFML/Graphics.hpp>
+
+// C++ standard libraries
+#include <vector>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+/// @brief the visible tiles in view as a texture with one texel per cell, drawn as a single quad scaled up by the cell size
+/// @note 4 bytes per tile instead of 6 vertices, and the cost doesn't depend on the cell size in pixels
+class TileTexture
+{
+public:
+
+    explicit TileTexture(int cellSizePixels)
+        : m_cellSize(static_cast<float>(cellSizePixels))
+    { }
+
+    /// @brief refill every texel if the fill changed, otherwise re-color only the cells edited since the last update with 1x1 sub-rect updates
+    /// @param fill the open area around the player, its bounds are the texture's bounds
+    void update(TileManager& tiles, const FloodFill& fill, int minX, int maxX, int minY, int maxY, bool visibilityChanged)
+    {
+        const std::array<int, 4> bounds { minX, maxX, minY, maxY };
+        std::span<const TileEdit> edits;
+        if (visibilityChanged || bounds != m_bounds || !tiles.getEditsSince(m_generation, edits))
+        {
+            rebuild(tiles, fill, bounds);
+        }
+        else
+        {
+            for (const TileEdit& edit : edits)
+            {
+                const Vec2i& cell = edit.cell;
+                if (!fill.contains(cell.x, cell.y))
+                {
+                    continue;
+                }
+
+                const std::array<uint8_t, 4> texel = getTexel(tiles, fill, cell.x, cell.y);
+                m_texture.update(texel.data(), { 1, 1 }, { static_cast<unsigned int>(cell.x - minX), static_cast<unsigned int>(cell.y - minY) });
+            }
+        }
+        m_generation = tiles.getEditGeneration();
+    }
+
+    void draw(sf::RenderTarget& target) const
+    {
+        sf::Sprite sprite(m_texture);
+        sprite.setPosition({ static_cast<float>(m_bounds[0]) * m_cellSize, static_cast<float>(m_bounds[2]) * m_cellSize });
+        sprite.setScale({ m_cellSize, m_cellSize });
+        target.draw(sprite);
+    }
+
+private:
+
+    float m_cellSize;
+    sf::Texture m_texture; // not smooth, so each texel scales up to a sharp cell
+    std::vector<uint8_t> m_pixels; // RGBA, row-major over the bounds, reused between rebuilds
+    std::array<int, 4> m_bounds { 0, -1, 0, -1 }; // minX, maxX, minY, maxY
+    uint64_t m_generation = 0; // tile edit generation the texture includes
+
+    /// @brief the tile color if the cell was reached by the fill and isn't air, otherwise transparent
+    static std::array<uint8_t, 4> getTexel(TileManager& tiles, const FloodFill& fill, int x, int y)
+    {
+        if (!fill.isVisited(x, y))
+        {
+            return { 0, 0, 0, 0 };
+        }
+
+        const TileType type = tiles.getType(x, y);
+        if (type == TileType::NONE)
+        {
+            return { 0, 0, 0, 0 };
+        }
+
+        const TileColor color = TileManager::getColor(type, x, y);
+        return { color.r, color.g, color.b, 255 };
+    }
+
+    void rebuild(TileManager& tiles, const FloodFill& fill, const std::array<int, 4>& bounds)
+    {
+        const auto [minX, maxX, minY, maxY] = bounds;
+        const sf::Vector2u size { static_cast<unsigned int>(maxX - minX + 1), static_cast<unsigned int>(maxY - minY + 1) };
+        if (m_texture.getSize() != size && !m_texture.resize(size))
+        {
+            std::cerr << "Could not create the tile texture\n";
+            exit(-1);
+        }
+        m_bounds = bounds;
+
+        m_pixels.resize(static_cast<size_t>(size.x * size.y * 4));
+        uint8_t* pixel = m_pixels.data();
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                const std::array<uint8_t, 4> texel = getTexel(tiles, fill, x, y);
+                pixel = std::copy(texel.begin(), texel.end(), pixel);
+            }
+        }
+        m_texture.update(m_pixels.data());
+    }
+};
@@ -37,7 +37,7 @@ NetworkManager::NetworkManager()
     }
 
     // create client
-    m_client = enet_host_create(nullptr, 1, 2, 0, 0); // no specified address, so client, can handle only 1 peer (the server), 2 communication channels, and no bandwidth limits
+    m_client = enet_host_create(nullptr, 1, NetworkChannel::NUM_CHANNELS, 0, 0); // no specified address, so client, can handle only 1 peer (the server), a reliable and a state channel, and no bandwidth limits
     if (!m_client)
     {
         std::cerr << "Failed to create client\n";
@@ -74,10 +74,28 @@ void NetworkManager::update()
 
             case ENET_EVENT_TYPE_RECEIVE:
             {
-                NetworkDatum received;
-                std::memcpy(&received, event.packet->data, sizeof(NetworkDatum));
-                std::cout << "Received data: " << received << "\n";
-                m_dataVec.push_back(received); /// TODO: consider adding things to multiple vectors, one for each type of data so that I can access each one at separate times in ScenePlay.cpp
+                // drop state batches older than one already received, their datums are out of date
+                const NetworkChannel::Channel channel = static_cast<NetworkChannel::Channel>(event.channelID);
+                NetworkBatch::Sequence sequence;
+                if (channel < NetworkChannel::NUM_CHANNELS && NetworkChannel::dropsStale(channel) && NetworkBatch::readSequence(event.packet->data, event.packet->dataLength, sequence))
+                {
+                    if (!NetworkBatch::isNewer(sequence, m_receivedSequence[channel]))
+                    {
+                        enet_packet_destroy(event.packet);
+                        break;
+                    }
+                    m_receivedSequence[channel] = sequence;
+                }
+
+                const size_t first = m_dataVec.size();
+                if (!NetworkBatch::unpack(event.packet->data, event.packet->dataLength, m_dataVec)) /// TODO: consider adding things to multiple vectors, one for each type of data so that I can access each one at separate times in ScenePlay.cpp
+                {
+                    std::cerr << "Received malformed packet of " << event.packet->dataLength << " bytes\n";
+                }
+                for (size_t i = first; i < m_dataVec.size(); ++i)
+                {
+                    std::cout << "Received data: " << m_dataVec[i] << "\n";
+                }
 
                 enet_packet_destroy(event.packet); // clean up memory after processing message
                 break;
@@ -98,9 +116,9 @@ const std::vector<NetworkDatum>& NetworkManager::getData() const
     return m_dataVec;
 }
 
-void NetworkManager::sendData(const NetworkDatum& data) const
+void NetworkManager::sendData(const NetworkDatum& data)
 {
-    std::cout << "Sending data: " << data << "\n";
+    std::cout << "Queueing data: " << data << "\n";
 
     if (!m_client)
     {
@@ -113,18 +131,56 @@ void NetworkManager::sendData(const NetworkDatum& data) const
         return;
     }
 
-    // std::vector<uint8_t> serializedData = NetworkSerializer<T>::serialize(data);
-    // ENetPacket* packet = enet_packet_create(
-    //     serializedData.data()
-    //     serializedData.size(),
-    //     ENET_PACKET_FLAG_RELIABLE
-    // ); // reliable means guaranteed to be delivered
+    const NetworkChannel::Channel channel = NetworkChannel::of(data.dataType);
+    if (m_outgoing[channel].isFull())
+    {
+        sendBatch(channel);
+    }
+    m_outgoing[channel].add(data);
+}
+
+void NetworkManager::flush()
+{
+    if (!m_peer || m_peer->state != ENET_PEER_STATE_CONNECTED)
+    {
+        return;
+    }
+
+    // acknowledge a newer snapshot once, a lost acknowledgement only makes the lobby's next deltas larger until a later one gets through
+    if (NetworkBatch::isNewer(m_appliedSnapshot, m_acknowledgedSnapshot))
+    {
+        sendData(NetworkDatum { NetworkDatum::DataType::SNAPSHOT, .first.id = m_appliedSnapshot });
+        m_acknowledgedSnapshot = m_appliedSnapshot;
+    }
+
+    bool sent = false;
+    for (uint8_t channel = 0; channel < NetworkChannel::NUM_CHANNELS; ++channel)
+    {
+        if (!m_outgoing[channel].empty())
+        {
+            sendBatch(static_cast<NetworkChannel::Channel>(channel));
+            sent = true;
+        }
+    }
+
+    // send out queued packets without dispatching any events
+    if (sent)
+    {
+        enet_host_flush(m_client); // forces immediate packet transmition, no wait for enet_host_service, just gives control over send timing really
+    }
+}
+
+void NetworkManager::sendBatch(NetworkChannel::Channel channel)
+{
+    NetworkBatch& batch = m_outgoing[channel];
+    batch.encode(++m_sentSequence[channel]);
 
     ENetPacket* packet = enet_packet_create(
-        &data,
-        sizeof(NetworkDatum),
-        ENET_PACKET_FLAG_RELIABLE
-    ); // reliable means guaranteed to be delivered
+        batch.data(),
+        batch.size(),
+        NetworkChannel::packetFlags(channel)
+    ); // reliable means guaranteed to be delivered, the state channel is unreliable but sequenced
+    batch.clear();
 
     if (!packet)
     {
@@ -133,27 +189,35 @@ void NetworkManager::sendData(const NetworkDatum& data) const
     }
 
     // send to server
-    if (enet_peer_send(m_peer, 0, packet) < 0) // packet queued but not immediately transmitted
+    if (enet_peer_send(m_peer, channel, packet) < 0) // packet queued but not immediately transmitted
     {
         std::cerr << "Failed to send packet\n";
-        return;
     }
+}
 
-    // send out queued packets without dispatching any events
-    enet_host_flush(m_client); // forces immediate packet transmition, no wait for enet_host_service, just gives control over send timing really
+void NetworkManager::acknowledgeSnapshot(NetworkBatch::Sequence tick)
+{
+    if (NetworkBatch::isNewer(tick, m_appliedSnapshot))
+    {
+        m_appliedSnapshot = tick;
+    }
 }
 
-void NetworkManager::updateIDMaps(EntityID localID, EntityID netID)
+void NetworkManager::updateIDMaps(const EntityHandle& local, EntityID netID)
 {
-    std::cout << "Mapping localID " << localID << " to netID " << netID << "\n";
-    m_netToLocalID[netID] = localID;
-    m_localToNetID[localID] = netID;
+    std::cout << "Mapping localID " << local.id << " to netID " << netID << "\n";
+    m_netToLocal[netID] = local;
+    if (local.id >= m_localToNetID.size())
+    {
+        m_localToNetID.resize(local.id + 1);
+    }
+    m_localToNetID[local.id] = netID;
 }
 
-EntityID NetworkManager::getLocalID(EntityID netID) const
+EntityHandle NetworkManager::getLocalHandle(EntityID netID) const
 {
-    std::cout << "Getting Local ID " << m_netToLocalID[netID] << " from Net ID " << netID << '\n';
-    return m_netToLocalID[netID];
+    std::cout << "Getting Local ID " << m_netToLocal[netID].id << " from Net ID " << netID << '\n';
+    return m_netToLocal[netID];
 }
 
 EntityID NetworkManager::getNetID(EntityID localID) const
@@ -181,8 +245,8 @@ void NetworkManager::connectTo(int addressP1, int addressP2, int addressP3, int
     }
     address.port = static_cast<enet_uint16>(port);
 
-    // send connection request to server, allocating two channels 0 and 1 (peer: connection in network, can be either a client connected to a server or a server that the client is connected to)
-    m_peer = enet_host_connect(m_client, &address, 2, 0); // client's host instance, server's address, channels, no user data passed to connection
+    // send connection request to server, allocating the reliable and state channels (peer: connection in network, can be either a client connected to a server or a server that the client is connected to)
+    m_peer = enet_host_connect(m_client, &address, NetworkChannel::NUM_CHANNELS, 0); // client's host instance, server's address, channels, no user data passed to connection
     if (!m_peer)
     {
         std::cerr << "Failed to initiate connection\n";
@@ -208,6 +272,15 @@ void NetworkManager::connectTo(int addressP1, int addressP2, int addressP3, int
 
 void NetworkManager::disconnect()
 {
+    // queued for the peer being left, and a new peer numbers its batches from the start
+    for (NetworkBatch& batch : m_outgoing)
+    {
+        batch.clear();
+    }
+    m_sentSequence.fill(0);
+    m_receivedSequence.fill(0);
+    m_appliedSnapshot = 0; // a new lobby numbers its snapshots from the start too
+    m_acknowledgedSnapshot = 0;
     if (m_peer)
     {
         enet_peer_disconnect(m_peer, 0);
@@ -10,6 +10,9 @@
 
 // Global
 #include "NetworkDatum.hpp"
+#include "NetworkBatch.hpp"
+#include "NetworkChannel.hpp"
+#include "EntityBase.hpp"
 
 // C++ standard libraries
 #include <enet/enet.h>
@@ -22,10 +25,17 @@ class NetworkManager
     ENetPeer* m_peer = nullptr;
 
     std::vector<NetworkDatum> m_dataVec;
+    std::array<NetworkBatch, NetworkChannel::NUM_CHANNELS> m_outgoing; // datums queued by sendData since the last flush, per channel
+    std::array<NetworkBatch::Sequence, NetworkChannel::NUM_CHANNELS> m_sentSequence {}; // sequence number of the last batch sent on each channel
+    std::array<NetworkBatch::Sequence, NetworkChannel::NUM_CHANNELS> m_receivedSequence {}; // newest batch received on each channel, older ones are dropped where the channel is unreliable
+    NetworkBatch::Sequence m_appliedSnapshot = 0; // newest lobby snapshot applied, 0 for none
+    NetworkBatch::Sequence m_acknowledgedSnapshot = 0; // newest lobby snapshot acknowledged to the lobby
+
+    void sendBatch(NetworkChannel::Channel channel);
 
     /// @todo could make unordered_map instead, removal of IDs fast with map.erase(key) function
-    std::array<EntityID, Settings::worldMaxEntities> m_netToLocalID; // map[net] = local
-    std::array<EntityID, Settings::worldMaxEntities> m_localToNetID; // map[local] = net
+    std::array<EntityHandle, Settings::worldMaxEntities> m_netToLocal; // map[net] = local, a handle so a despawned entity's slot being reused doesn't redirect its net ID
+    std::vector<EntityID> m_localToNetID; // map[local] = net, grows with the local entity pool
 
 public:
 
@@ -38,12 +48,18 @@ public:
     const std::vector<NetworkDatum>& getData() const;
 
     /// TODO: test this with different OSs, check for endianness, same floating-point rep, padding
-    /// @brief send data to server, only works with POD
-    void sendData(const NetworkDatum& data) const;
+    /// @brief queue data for the server, it goes out with everything else queued this frame on the next flush
+    void sendData(const NetworkDatum& data);
+
+    /// @brief send every queued datum to the server as one packet per channel, called once per frame
+    void flush();
+
+    /// @brief record that the datums of lobby snapshot tick have been applied, the lobby sends later deltas against the newest one, see LobbyServer::takeSnapshot
+    void acknowledgeSnapshot(NetworkBatch::Sequence tick);
 
-    void updateIDMaps(EntityID localID, EntityID netID);
+    void updateIDMaps(const EntityHandle& local, EntityID netID);
 
-    EntityID getLocalID(EntityID netID) const;
+    EntityHandle getLocalHandle(EntityID netID) const;
     EntityID getNetID(EntityID localID) const;
 
     void connectTo(int addressP1, int addressP2, int addressP3, int addressP4, int port);
@@ -11,12 +11,6 @@
 
 namespace Settings
 {
-    inline constexpr int worldMaxCellsX = 4000;
-    inline constexpr int worldMaxCellsY = 1000;
-    static_assert(4000 * 1000 < std::numeric_limits<int>::max(), "worldMaxCellsX * worldMaxCellsY must be less than the largest possible int");
-
-    inline constexpr int cellSizePixels = 10;
-
     inline int windowSizeX = 1920; // default value, overriden by fullscreen mode, consider eliminating this variable (not constexpr)
     inline int windowSizeY = 1080; // default value, overriden by fullscreen mode, consider eliminating this variable (not constexpr)
 
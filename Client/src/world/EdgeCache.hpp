@@ -0,0 +1,221 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "TileBitset.hpp"
+
+// Physics
+#include "physics/Vec2.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+/// @brief a horizontal or vertical run of faces between solid cells and open cells, in grid corner coords
+struct EdgeSegment
+{
+    Vec2i a, b; // a is the top or left end
+    Vec2i normal; // points out of the solid side
+};
+
+/// @brief greedy-merged edge segments of one bitset layer, stored per 64x64 chunk and patched line by line when a cell changes
+/// @note a face belongs to the chunk of its solid cell, cells outside the world count as solid so the world border has no faces
+/// chunks are 64 cells wide like TileBitset words, so one row of a chunk is exactly one word
+class EdgeCache
+{
+public:
+
+    static constexpr int chunkSize = TileBitset::wordBits;
+    static constexpr int chunkShift = TileBitset::wordShift;
+
+    EdgeCache(int cellsX, int cellsY)
+        : m_cellsX(cellsX)
+        , m_cellsY(cellsY)
+        , m_chunksX((cellsX + chunkSize - 1) >> chunkShift)
+        , m_chunksY((cellsY + chunkSize - 1) >> chunkShift)
+        , m_chunkSegments(static_cast<size_t>(m_chunksX * m_chunksY))
+    { }
+
+    /// @brief extract every chunk's segments from scratch
+    void build(const TileBitset& solid)
+    {
+        for (int cy = 0; cy < m_chunksY; ++cy)
+        {
+            for (int cx = 0; cx < m_chunksX; ++cx)
+            {
+                m_chunkSegments[chunkIndex(cx, cy)].clear();
+                for (int line = cy << chunkShift; line <= (cy + 1) << chunkShift; ++line)
+                {
+                    extractHorizontalLine(solid, cx, cy, line);
+                }
+                for (int line = cx << chunkShift; line <= (cx + 1) << chunkShift; ++line)
+                {
+                    extractVerticalLine(solid, cx, cy, line);
+                }
+            }
+        }
+    }
+
+    /// @brief re-extract the four grid lines around cell (x, y) after it changed between solid and open
+    void patch(const TileBitset& solid, int x, int y)
+    {
+        const int cx = x >> chunkShift;
+        const int cy = y >> chunkShift;
+
+        for (int line = y; line <= y + 1; ++line)
+        {
+            // faces on a horizontal line belong to the chunk above or below it, the same chunk unless the line is a chunk border
+            for (int owner = (line - 1) >> chunkShift; owner <= line >> chunkShift; ++owner)
+            {
+                if (owner >= 0 && owner < m_chunksY)
+                {
+                    eraseLine(cx, owner, line, true);
+                    extractHorizontalLine(solid, cx, owner, line);
+                }
+            }
+        }
+
+        for (int line = x; line <= x + 1; ++line)
+        {
+            for (int owner = (line - 1) >> chunkShift; owner <= line >> chunkShift; ++owner)
+            {
+                if (owner >= 0 && owner < m_chunksX)
+                {
+                    eraseLine(owner, cy, line, false);
+                    extractVerticalLine(solid, owner, cy, line);
+                }
+            }
+        }
+    }
+
+    /// @brief append the segments of every chunk overlapping the inclusive cell rectangle, segments are not clipped to it
+    void collect(int minX, int maxX, int minY, int maxY, std::vector<EdgeSegment>& segments) const
+    {
+        for (int cy = std::max(0, minY >> chunkShift); cy <= std::min(m_chunksY - 1, maxY >> chunkShift); ++cy)
+        {
+            for (int cx = std::max(0, minX >> chunkShift); cx <= std::min(m_chunksX - 1, maxX >> chunkShift); ++cx)
+            {
+                const std::vector<EdgeSegment>& chunk = m_chunkSegments[chunkIndex(cx, cy)];
+                segments.insert(segments.end(), chunk.begin(), chunk.end());
+            }
+        }
+    }
+
+    const std::vector<EdgeSegment>& getChunkSegments(int cx, int cy) const
+    {
+        return m_chunkSegments[chunkIndex(cx, cy)];
+    }
+
+private:
+
+    int m_cellsX;
+    int m_cellsY;
+    int m_chunksX;
+    int m_chunksY;
+    std::vector<std::vector<EdgeSegment>> m_chunkSegments; // chunk (cx, cy) at cy * m_chunksX + cx
+
+    size_t chunkIndex(int cx, int cy) const
+    {
+        return static_cast<size_t>(cy * m_chunksX + cx);
+    }
+
+    /// @brief bits of chunk column cx's cells that are inside the world
+    uint64_t validMask(int cx) const
+    {
+        const int cellsInWord = std::min(chunkSize, m_cellsX - (cx << chunkShift));
+        return cellsInWord == chunkSize ? ~uint64_t { 0 } : (uint64_t { 1 } << cellsInWord) - 1;
+    }
+
+    /// @brief row y of chunk column cx, with cells outside the world set
+    uint64_t solidWord(const TileBitset& solid, int cx, int y) const
+    {
+        if (y < 0 || y >= m_cellsY)
+        {
+            return ~uint64_t { 0 };
+        }
+        return solid.getWord(cx, y) | ~validMask(cx);
+    }
+
+    bool solidCell(const TileBitset& solid, int x, int y) const
+    {
+        return x < 0 || y < 0 || x >= m_cellsX || y >= m_cellsY || solid.test(x, y);
+    }
+
+    void eraseLine(int cx, int cy, int line, bool horizontal)
+    {
+        std::vector<EdgeSegment>& segments = m_chunkSegments[chunkIndex(cx, cy)];
+        std::erase_if(segments, [line, horizontal](const EdgeSegment& s)
+        {
+            return horizontal ? (s.a.y == line && s.b.y == line) : (s.a.x == line && s.b.x == line);
+        });
+    }
+
+    /// @brief add a segment for every run of set bits in faces, a word of chunk column cx on horizontal grid line line
+    void addRuns(uint64_t faces, int cx, int line, const Vec2i& normal, std::vector<EdgeSegment>& segments)
+    {
+        const int x0 = cx << chunkShift;
+        while (faces)
+        {
+            const int start = std::countr_zero(faces);
+            const int length = std::countr_one(faces >> start);
+            segments.push_back({ { x0 + start, line }, { x0 + start + length, line }, normal });
+            faces = length + start >= chunkSize ? 0 : faces & (~uint64_t { 0 } << (start + length));
+        }
+    }
+
+    /// @brief faces on horizontal grid line line (between rows line - 1 and line) whose solid cell is in chunk (cx, cy)
+    void extractHorizontalLine(const TileBitset& solid, int cx, int cy, int line)
+    {
+        std::vector<EdgeSegment>& segments = m_chunkSegments[chunkIndex(cx, cy)];
+        const int y0 = cy << chunkShift;
+        const uint64_t above = solidWord(solid, cx, line - 1);
+        const uint64_t below = solidWord(solid, cx, line);
+
+        if (line >= y0 && line < y0 + chunkSize && line < m_cellsY) // top faces of row line
+        {
+            addRuns(below & ~above & validMask(cx), cx, line, { 0, -1 }, segments);
+        }
+        if (line - 1 >= y0 && line - 1 < y0 + chunkSize && line - 1 < m_cellsY) // bottom faces of row line - 1
+        {
+            addRuns(above & ~below & validMask(cx), cx, line, { 0, 1 }, segments);
+        }
+    }
+
+    /// @brief faces on vertical grid line line (between columns line - 1 and line) whose solid cell is in chunk (cx, cy)
+    void extractVerticalLine(const TileBitset& solid, int cx, int cy, int line)
+    {
+        std::vector<EdgeSegment>& segments = m_chunkSegments[chunkIndex(cx, cy)];
+        const int x0 = cx << chunkShift;
+        const int y0 = cy << chunkShift;
+        const int yEnd = std::min(y0 + chunkSize, m_cellsY);
+
+        for (int side = 0; side < 2; ++side)
+        {
+            const int solidX = side == 0 ? line : line - 1; // left faces of column line, then right faces of column line - 1
+            const int openX = side == 0 ? line - 1 : line;
+            if (solidX < x0 || solidX >= x0 + chunkSize || solidX >= m_cellsX)
+            {
+                continue;
+            }
+
+            const Vec2i normal { side == 0 ? -1 : 1, 0 };
+            int runStart = -1;
+            for (int y = y0; y <= yEnd; ++y)
+            {
+                const bool face = y < yEnd && solidCell(solid, solidX, y) && !solidCell(solid, openX, y);
+                if (face && runStart < 0)
+                {
+                    runStart = y;
+                }
+                else if (!face && runStart >= 0)
+                {
+                    segments.push_back({ { line, runStart }, { line, y }, normal });
+                    runStart = -1;
+                }
+            }
+        }
+    }
+};
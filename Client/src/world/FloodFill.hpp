@@ -0,0 +1,184 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "TileBitset.hpp"
+
+// Physics
+#include "physics/Vec2.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <cstdint>
+
+/// @brief iterative scanline flood fill over the open (non-vision-blocking) cells around a start cell, bounded to a rectangle
+/// @note buffers are members and only grow, so filling every frame doesn't allocate once the largest bounds have been seen
+class FloodFill
+{
+public:
+
+    /// @brief fill the open area connected to start within [minX, maxX] x [minY, maxY]
+    /// @param blocked cells that stop the fill, each one reached is marked visited and added to the boundary
+    void run(const TileBitset& blocked, const Vec2i& start, int minX, int maxX, int minY, int maxY)
+    {
+        m_minX = minX;
+        m_maxX = maxX;
+        m_minY = minY;
+        m_maxY = maxY;
+        m_width = maxX - minX + 1;
+        m_visited.assign(static_cast<size_t>(m_width * (maxY - minY + 1)), 0);
+        m_boundary.clear();
+        m_seeds.clear();
+
+        if (start.x < minX || start.x > maxX || start.y < minY || start.y > maxY)
+        {
+            return;
+        }
+
+        if (blocked.test(start.x, start.y))
+        {
+            markBoundary(start.x, start.y);
+            return;
+        }
+
+        m_seeds.push_back(start);
+        fill(blocked);
+    }
+
+    /// @brief grow the filled area after cell stopped blocking, without refilling what is already visited
+    /// @return true if the filled area changed, false if cell wasn't on the boundary (not visible from the start cell)
+    bool reopen(const TileBitset& blocked, const Vec2i& cell)
+    {
+        if (!contains(cell.x, cell.y) || !isVisited(cell.x, cell.y) || blocked.test(cell.x, cell.y))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < m_boundary.size(); ++i)
+        {
+            if (m_boundary[i] == cell)
+            {
+                m_boundary[i] = m_boundary.back();
+                m_boundary.pop_back();
+
+                m_visited[index(cell.x, cell.y)] = 0;
+                m_seeds.push_back(cell);
+                fill(blocked); // the reopened run may join already filled runs, refilling those is harmless
+                return true;
+            }
+        }
+
+        return false; // visited open cell, e.g. a background wall was destroyed
+    }
+
+    bool contains(int x, int y) const
+    {
+        return x >= m_minX && x <= m_maxX && y >= m_minY && y <= m_maxY;
+    }
+
+    bool isVisited(int x, int y) const
+    {
+        return m_visited[index(x, y)];
+    }
+
+    /// @brief vision-blocking cells that border the filled area
+    const std::vector<Vec2i>& getBoundary() const
+    {
+        return m_boundary;
+    }
+
+private:
+
+    std::vector<Vec2i> m_seeds; // one per open run still to fill
+    std::vector<char> m_visited; // row-major over the bounds, filled open cells and boundary cells
+    std::vector<Vec2i> m_boundary;
+
+    int m_minX = 0;
+    int m_maxX = -1;
+    int m_minY = 0;
+    int m_maxY = -1;
+    int m_width = 0;
+
+    void fill(const TileBitset& blocked)
+    {
+        const int minX = m_minX;
+        const int maxX = m_maxX;
+        const int minY = m_minY;
+        const int maxY = m_maxY;
+
+        while (!m_seeds.empty())
+        {
+            const Vec2i seed = m_seeds.back();
+            m_seeds.pop_back();
+
+            if (isVisited(seed.x, seed.y))
+            {
+                continue; // open runs are filled all at once, so another seed in this run got here first
+            }
+
+            // grow the seed into the whole open run on its row, 64 cells per word test
+            const int left = blocked.findPrevSet(seed.y, seed.x, minX) + 1;
+            const int right = blocked.findNextSet(seed.y, seed.x, maxX) - 1;
+
+            for (int x = left; x <= right; ++x)
+            {
+                m_visited[index(x, seed.y)] = 1;
+            }
+            if (left > minX)
+            {
+                markBoundary(left - 1, seed.y);
+            }
+            if (right < maxX)
+            {
+                markBoundary(right + 1, seed.y);
+            }
+
+            if (seed.y > minY)
+            {
+                scanRow(blocked, left, right, seed.y - 1);
+            }
+            if (seed.y < maxY)
+            {
+                scanRow(blocked, left, right, seed.y + 1);
+            }
+        }
+    }
+
+    size_t index(int x, int y) const
+    {
+        return static_cast<size_t>((y - m_minY) * m_width + (x - m_minX));
+    }
+
+    void markBoundary(int x, int y)
+    {
+        char& visited = m_visited[index(x, y)];
+        if (!visited)
+        {
+            visited = 1;
+            m_boundary.emplace_back(x, y);
+        }
+    }
+
+    /// @brief seed every unvisited open run in row y that touches [left, right], and record blocked cells along the way
+    void scanRow(const TileBitset& blocked, int left, int right, int y)
+    {
+        bool inRun = false;
+        for (int x = left; x <= right; ++x)
+        {
+            if (blocked.test(x, y))
+            {
+                markBoundary(x, y);
+                inRun = false;
+            }
+            else if (!inRun)
+            {
+                inRun = true;
+                if (!isVisited(x, y))
+                {
+                    m_seeds.emplace_back(x, y);
+                }
+            }
+        }
+    }
+};
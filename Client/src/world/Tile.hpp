@@ -6,13 +6,50 @@
 #include "TileType.hpp"
 
 // C++ standard libraries
+#include <array>
 #include <cstdint>
 
-/// TODO: consider finding way to eleminate redundancies between TileType and properties that are constant for that tile type like vision and movement blocks, max health
+/// @brief per-cell tile data, everything that is constant for a TileType lives in the TileProperties table instead
 struct Tile
 {
     TileType type = TileType::NONE;
-    uint8_t r, g, b, light = 0;
-    bool blocksVision, blocksMovement = false;
-    int health = 0; // if health is zero, tile inactive
+    uint8_t health = 0; // if health is zero, tile inactive
 };
+
+struct TileColor
+{
+    uint8_t r = 0, g = 0, b = 0;
+};
+
+/// @brief properties shared by every tile of one TileType
+struct TileProperties
+{
+    bool blocksMovement = false;
+    bool blocksVision = false;
+    uint8_t maxHealth = 0;
+    TileColor baseColor;
+};
+
+constexpr size_t numTileTypes = static_cast<size_t>(TileType::BEDROCK) + 1;
+
+/// @brief TileProperties indexed by TileType
+/// TODO: glass, bulletproof glass, and bedrock aren't generated yet, their health and colors are placeholders
+constexpr std::array<TileProperties, numTileTypes> tileProperties {{
+    { false, false, 0, { 0, 0, 0 } }, // NONE
+    { true, true, 40, { 50, 30, 20 } }, // DIRT
+    { false, false, 10, { 25, 15, 10 } }, // DIRTWALL
+    { true, true, 60, { 70, 70, 70 } }, // STONE
+    { false, false, 10, { 35, 35, 35 } }, // STONEWALL
+    { true, true, 100, { 50, 0, 0 } }, // BRICK
+    { false, false, 10, { 25, 0, 0 } }, // BRICKWALL
+    { true, false, 5, { 150, 200, 210 } }, // GLASS
+    { true, false, 255, { 120, 170, 180 } }, // BULLETPROOFGLASS
+    { true, true, 255, { 15, 15, 15 } } // BEDROCK
+}};
+
+constexpr const TileProperties& getTileProperties(TileType type)
+{
+    return tileProperties[static_cast<size_t>(type)];
+}
+
+static_assert(sizeof(Tile) == 2, "Tile is hot data, keep it to a type byte and a health byte");
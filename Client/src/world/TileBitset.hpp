@@ -0,0 +1,125 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// C++ standard libraries
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cassert>
+
+/// @brief one bit per cell, stored row-major in 64-bit words so a row of 64 cells is tested with a single load
+/// @note bit (x & 63) of word (y * wordsPerRow + (x >> 6)) is cell (x, y), bits past the world width are always zero
+class TileBitset
+{
+public:
+
+    static constexpr int wordBits = 64;
+    static constexpr int wordShift = 6;
+
+    TileBitset(int cellsX, int cellsY)
+        : m_cellsX(cellsX)
+        , m_cellsY(cellsY)
+        , m_wordsPerRow((cellsX + wordBits - 1) >> wordShift)
+        , m_words(static_cast<size_t>(m_wordsPerRow * cellsY), 0)
+    { }
+
+    bool test(int x, int y) const
+    {
+        assert(x >= 0 && y >= 0 && x < m_cellsX && y < m_cellsY);
+        return (m_words[wordIndex(x, y)] >> (x & (wordBits - 1))) & 1u;
+    }
+
+    void set(int x, int y, bool value)
+    {
+        assert(x >= 0 && y >= 0 && x < m_cellsX && y < m_cellsY);
+        const uint64_t bit = uint64_t { 1 } << (x & (wordBits - 1));
+        uint64_t& word = m_words[wordIndex(x, y)];
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    /// @brief the word holding cells [wordX * 64, wordX * 64 + 63] of row y
+    uint64_t getWord(int wordX, int y) const
+    {
+        return m_words[static_cast<size_t>(y * m_wordsPerRow + wordX)];
+    }
+
+    int getWordsPerRow() const
+    {
+        return m_wordsPerRow;
+    }
+
+    /// @brief mask with bits [lo, hi] set, both in [0, 63]
+    static uint64_t rangeMask(int lo, int hi)
+    {
+        const uint64_t upper = hi == wordBits - 1 ? ~uint64_t { 0 } : (uint64_t { 1 } << (hi + 1)) - 1;
+        return upper & (~uint64_t { 0 } << lo);
+    }
+
+    /// @brief first set cell in row y within [x, maxX], or maxX + 1 if none
+    int findNextSet(int y, int x, int maxX) const
+    {
+        while (x <= maxX)
+        {
+            const int w = x >> wordShift;
+            const int hi = std::min(maxX - (w << wordShift), wordBits - 1);
+            const uint64_t bits = getWord(w, y) & rangeMask(x & (wordBits - 1), hi);
+            if (bits)
+            {
+                return (w << wordShift) + std::countr_zero(bits);
+            }
+            x = (w + 1) << wordShift;
+        }
+        return maxX + 1;
+    }
+
+    /// @brief last set cell in row y within [minX, x], or minX - 1 if none
+    int findPrevSet(int y, int x, int minX) const
+    {
+        while (x >= minX)
+        {
+            const int w = x >> wordShift;
+            const int lo = std::max(minX - (w << wordShift), 0);
+            const uint64_t bits = getWord(w, y) & rangeMask(lo, x & (wordBits - 1));
+            if (bits)
+            {
+                return (w << wordShift) + wordBits - 1 - std::countl_zero(bits);
+            }
+            x = (w << wordShift) - 1;
+        }
+        return minX - 1;
+    }
+
+    /// @brief true if any cell in the inclusive rectangle [minX, maxX] x [minY, maxY] is set
+    bool anyInRect(int minX, int maxX, int minY, int maxY) const
+    {
+        const int firstWord = minX >> wordShift;
+        const int lastWord = maxX >> wordShift;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int w = firstWord; w <= lastWord; ++w)
+            {
+                const int lo = w == firstWord ? minX & (wordBits - 1) : 0;
+                const int hi = w == lastWord ? maxX & (wordBits - 1) : wordBits - 1;
+                if (getWord(w, y) & rangeMask(lo, hi))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+
+    int m_cellsX;
+    int m_cellsY;
+    int m_wordsPerRow;
+    std::vector<uint64_t> m_words;
+
+    size_t wordIndex(int x, int y) const
+    {
+        return static_cast<size_t>(y * m_wordsPerRow + (x >> wordShift));
+    }
+};
@@ -4,33 +4,501 @@
 
 // World
 #include "Tile.hpp"
+#include "TileBitset.hpp"
+#include "EdgeCache.hpp"
+#include "TileType.hpp"
+#include "WorldGenerator.hpp"
+
+// Physics
+#include "physics/Vec2.hpp"
 
 // Utility
 #include "utility/ClientGlobals.hpp"
 
+// Global
+#include "Random.hpp"
+
 // C++ standard libraries
 #include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <optional>
+
+/// @brief a cell whose TileType changed, generation is the edit generation right after the change
+struct TileEdit
+{
+    Vec2i cell;
+    uint64_t generation = 0;
+};
 
+/// @brief owns the tile grid, stored as fixed-size chunks that are allocated lazily
+/// @note a chunk is UNIFORM (one TileType for every cell, no per-cell storage) until a cell in it is edited, DENSE while its tiles live in memory, and EVICTED while they don't; reading an evicted chunk loads it back
+/// an evicted chunk that was never edited is generated again from the seed, only edited ones are written to disk
 class TileManager
 {
+public:
+
+    static constexpr int chunkSize = 64; // cells per chunk side, power of 2 so cell -> chunk is a shift and a mask
+    static constexpr int chunkShift = 6;
+    static constexpr int chunkMask = chunkSize - 1;
+    static_assert(1 << chunkShift == chunkSize, "chunkShift must match chunkSize");
+
+    static constexpr int evictMarginChunks = 2; // dense chunks this many chunks past every player's view are evicted, at least TileChunkMeshes::keepDistanceChunks so a kept mesh is patched without a reload
+    static constexpr size_t maxLoggedEdits = 4096; // older edits are dropped, consumers that fall that far behind rebuild from scratch
+
+    TileManager()
+    {
+        m_chunks.resize(static_cast<size_t>(m_chunksX * m_chunksY));
+    }
+
+    ~TileManager()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(m_evictDirectory, ec); // evicted chunks only belong to this session
+    }
+
+    /// @brief generate the world from worldSeed chunk by chunk, dropping any previous world
+    /// @note only the bitset layers and edge caches are filled, a chunk with a single type becomes UNIFORM and every other one starts EVICTED and is generated again on first access
+    void loadWorld(int worldSeed)
+    {
+        m_generator.emplace(m_worldMaxCellsX, m_worldMaxCellsY, worldSeed);
+        m_editLog.clear();
+        ++m_editGeneration; // with an empty log, anything cached from before this world is rebuilt
+
+        m_residentChunks.clear();
+        std::error_code ec;
+        std::filesystem::remove_all(m_evictDirectory, ec); // chunks edited in the previous world
+
+        std::vector<TileType> types(static_cast<size_t>(chunkSize * chunkSize));
+        for (int cy = 0; cy < m_chunksY; ++cy)
+        {
+            for (int cx = 0; cx < m_chunksX; ++cx)
+            {
+                Chunk& chunk = m_chunks[chunkIndex(cx, cy)];
+                chunk = Chunk(); // frees the previous world's tiles
+                m_generator->generateChunk(cx << chunkShift, cy << chunkShift, chunkSize, types);
+
+                const int xEnd = std::min((cx + 1) << chunkShift, m_worldMaxCellsX);
+                const int yEnd = std::min((cy + 1) << chunkShift, m_worldMaxCellsY);
+                const TileType first = types[0];
+                bool uniform = true;
+                for (int y = cy << chunkShift; y < yEnd; ++y)
+                {
+                    for (int x = cx << chunkShift; x < xEnd; ++x)
+                    {
+                        const TileType type = types[localIndex(x, y)];
+                        uniform = uniform && type == first;
+                        setLayers(x, y, type);
+                    }
+                }
+
+                chunk.uniformType = first;
+                chunk.state = uniform ? ChunkState::UNIFORM : ChunkState::EVICTED;
+            }
+        }
+
+        m_movementEdges.build(m_blocksMovement);
+        m_visionEdges.build(m_blocksVision);
+    }
+
+    bool inBounds(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && x < m_worldMaxCellsX && y < m_worldMaxCellsY;
+    }
+
+    /// @brief get a copy of the tile at cell (x, y)
+    Tile getTile(int x, int y)
+    {
+        const Chunk& chunk = readChunk(x, y);
+        if (chunk.state == ChunkState::UNIFORM)
+        {
+            return createTile(chunk.uniformType);
+        }
+        return { chunk.types[localIndex(x, y)], chunk.health[localIndex(x, y)] };
+    }
+
+    TileType getType(int x, int y)
+    {
+        const Chunk& chunk = readChunk(x, y);
+        return chunk.state == ChunkState::UNIFORM ? chunk.uniformType : chunk.types[localIndex(x, y)];
+    }
+
+    /// @note reads the bitset layer, so this never touches chunk storage or loads an evicted chunk
+    bool blocksMovement(int x, int y) const
+    {
+        return m_blocksMovement.test(x, y);
+    }
+
+    bool blocksVision(int x, int y) const
+    {
+        return m_blocksVision.test(x, y);
+    }
+
+    const TileBitset& getMovementLayer() const
+    {
+        return m_blocksMovement;
+    }
+
+    const TileBitset& getVisionLayer() const
+    {
+        return m_blocksVision;
+    }
+
+    /// @brief merged faces of the tiles that block movement, for collision queries
+    const EdgeCache& getMovementEdges() const
+    {
+        return m_movementEdges;
+    }
+
+    /// @brief merged faces of the tiles that block vision, for ray casting and lighting
+    const EdgeCache& getVisionEdges() const
+    {
+        return m_visionEdges;
+    }
+
+    /// @brief overwrite the tile at cell (x, y), expanding a UNIFORM chunk to DENSE first and marking the chunk dirty
+    void setTile(int x, int y, const Tile& tile)
+    {
+        assert(inBounds(x, y));
+
+        const size_t index = chunkIndex(x >> chunkShift, y >> chunkShift);
+        Chunk& chunk = m_chunks[index];
+
+        if (chunk.state == ChunkState::EVICTED)
+        {
+            loadChunk(chunk, index);
+        }
+        else if (chunk.state == ChunkState::UNIFORM)
+        {
+            if (tile.type == chunk.uniformType && tile.health == getTileProperties(tile.type).maxHealth)
+            {
+                return;
+            }
+
+            chunk.types.assign(static_cast<size_t>(chunkSize * chunkSize), chunk.uniformType);
+            chunk.health.assign(static_cast<size_t>(chunkSize * chunkSize), getTileProperties(chunk.uniformType).maxHealth);
+            makeResident(chunk, index);
+        }
+
+        chunk.dirty = true;
+        TileType& type = chunk.types[localIndex(x, y)];
+        chunk.health[localIndex(x, y)] = tile.health;
+        if (type != tile.type)
+        {
+            type = tile.type;
+            setLayers(x, y, tile.type, true);
+            logEdit(x, y);
+        }
+    }
+
+    /// @brief number of TileType changes so far, compare against a saved value to see if anything changed
+    uint64_t getEditGeneration() const
+    {
+        return m_editGeneration;
+    }
+
+    /// @brief get the edits made after generation, oldest first
+    /// @return false if some of them were already dropped from the log, the caller has to rebuild from scratch
+    bool getEditsSince(uint64_t generation, std::span<const TileEdit>& edits) const
+    {
+        edits = {};
+        if (generation >= m_editGeneration)
+        {
+            return true;
+        }
+        if (m_editLog.empty() || generation + 1 < m_editLog.front().generation)
+        {
+            return false;
+        }
+        edits = std::span<const TileEdit>(m_editLog).subspan(static_cast<size_t>(generation + 1 - m_editLog.front().generation));
+        return true;
+    }
+
+    /// @brief evict dense chunks that are out of every player's view, writing the dirty ones to disk
+    /// @param playerCells grid positions of every player in the world
+    /// @param halfViewCells half the view size in cells, the view is centered on each player
+    void streamChunks(const std::vector<Vec2i>& playerCells, Vec2i halfViewCells)
+    {
+        const int keepX = ((halfViewCells.x + chunkMask) >> chunkShift) + evictMarginChunks;
+        const int keepY = ((halfViewCells.y + chunkMask) >> chunkShift) + evictMarginChunks;
+        for (size_t i = 0; i < m_residentChunks.size();)
+        {
+            const size_t index = m_residentChunks[i];
+            const int cx = static_cast<int>(index % static_cast<size_t>(m_chunksX));
+            const int cy = static_cast<int>(index / static_cast<size_t>(m_chunksX));
+
+            bool nearPlayer = false;
+            for (const Vec2i& cell : playerCells)
+            {
+                if (abs((cell.x >> chunkShift) - cx) <= keepX && abs((cell.y >> chunkShift) - cy) <= keepY)
+                {
+                    nearPlayer = true;
+                    break;
+                }
+            }
+
+            if (nearPlayer || !evictChunk(m_chunks[index], index))
+            {
+                ++i;
+                continue;
+            }
+
+            m_residentChunks[i] = m_residentChunks.back();
+            m_residentChunks.pop_back();
+        }
+    }
+
+    /// @brief number of chunks currently holding per-cell tiles in memory
+    size_t getResidentChunkCount() const
+    {
+        return m_residentChunks.size();
+    }
+
+    /// @brief whether chunk (cx, cy) was edited since the world was loaded, every other chunk still holds what the generator made
+    bool isChunkEdited(int cx, int cy) const
+    {
+        const Chunk& chunk = m_chunks[chunkIndex(cx, cy)];
+        return chunk.dirty || chunk.saved;
+    }
+
+    /// @brief copy the types of chunk (cx, cy) into types (row-major, chunkSize * chunkSize) without making it resident
+    /// @note for consumers that look at a chunk once, like a map, an evicted chunk is read or generated into types and dropped again
+    void copyChunkTypes(int cx, int cy, std::span<TileType> types) const
+    {
+        assert(types.size() >= static_cast<size_t>(chunkSize * chunkSize));
+
+        const size_t index = chunkIndex(cx, cy);
+        const Chunk& chunk = m_chunks[index];
+        switch (chunk.state)
+        {
+            case ChunkState::UNIFORM:
+                std::fill_n(types.begin(), chunkSize * chunkSize, chunk.uniformType);
+                break;
+            case ChunkState::DENSE:
+                std::copy(chunk.types.begin(), chunk.types.end(), types.begin());
+                break;
+            case ChunkState::EVICTED:
+                readTypes(chunk, index, types);
+                break;
+        }
+    }
+
+    /// @brief a full-health tile of type type
+    static Tile createTile(TileType type)
+    {
+        return { type, getTileProperties(type).maxHealth };
+    }
+
+    /// @brief color of a tile of type type at cell (x, y), the type's base color plus a small per-cell shade variation
+    /// @note the shade is a hash of the cell so it doesn't need to be stored, channels that are zero in the base color stay zero
+    static TileColor getColor(TileType type, int x, int y)
+    {
+        TileColor color = getTileProperties(type).baseColor;
+        const uint8_t shade = cellShade(x, y);
+        color.r = color.r ? static_cast<uint8_t>(color.r + shade) : 0;
+        color.g = color.g ? static_cast<uint8_t>(color.g + shade) : 0;
+        color.b = color.b ? static_cast<uint8_t>(color.b + shade) : 0;
+        return color;
+    }
+
+private:
+
+    enum class ChunkState : uint8_t
+    {
+        UNIFORM,
+        DENSE,
+        EVICTED
+    };
+
+    /// @brief structure of arrays so collision and vision scans only touch the type bytes
+    struct Chunk
+    {
+        std::vector<TileType> types; // row-major chunkSize * chunkSize cells, empty unless DENSE
+        std::vector<uint8_t> health; // same layout as types
+        TileType uniformType = TileType::NONE; // type of every cell while UNIFORM, at full health
+        ChunkState state = ChunkState::UNIFORM;
+        bool dirty = false; // edited since it was last generated or loaded, evicting has to write it out
+        bool saved = false; // its tiles are on disk, loading reads them instead of generating the chunk again
+    };
+
     const int m_worldMaxCellsX = Settings::worldMaxCellsX;
     const int m_worldMaxCellsY = Settings::worldMaxCellsY;
+    const int m_chunksX = (m_worldMaxCellsX + chunkMask) >> chunkShift;
+    const int m_chunksY = (m_worldMaxCellsY + chunkMask) >> chunkShift;
 
-    std::vector<Tile> m_tiles { static_cast<size_t>(m_worldMaxCellsX * m_worldMaxCellsY) };
+    std::vector<Chunk> m_chunks; // chunk (cx, cy) at cy * m_chunksX + cx
+    std::vector<size_t> m_residentChunks; // indices of DENSE chunks, the only ones that can be evicted
+    std::optional<WorldGenerator> m_generator; // regenerates evicted chunks that were never edited, set by loadWorld
 
-    /// TODO: also consider chunk-based (map of pairs to chunks and chunks are 1d flat arrays of tiles) or quadtree storage, both are more efficient memory usage for more sparse worlds, efficient neighbor access, dynamic world size, and can still check neighbors with the indices regardless
+    uint64_t m_editGeneration = 0;
+    std::vector<TileEdit> m_editLog; // consecutive generations, at most maxLoggedEdits
 
-public:
+    // always resident, kept in sync with the chunks by loadWorld and setTile
+    TileBitset m_blocksMovement { m_worldMaxCellsX, m_worldMaxCellsY };
+    TileBitset m_blocksVision { m_worldMaxCellsX, m_worldMaxCellsY };
+    EdgeCache m_movementEdges { m_worldMaxCellsX, m_worldMaxCellsY };
+    EdgeCache m_visionEdges { m_worldMaxCellsX, m_worldMaxCellsY };
+
+    const std::filesystem::path m_evictDirectory {
+        std::filesystem::temp_directory_path() / ("chunks_" + std::to_string(Random::getIntegral(0, std::numeric_limits<int>::max())))
+    };
+
+    size_t chunkIndex(int cx, int cy) const
+    {
+        return static_cast<size_t>(cy * m_chunksX + cx);
+    }
+
+    static size_t localIndex(int x, int y)
+    {
+        return static_cast<size_t>(((y & chunkMask) << chunkShift) + (x & chunkMask));
+    }
+
+    /// @note loadWorld builds the edge caches once at the end instead of patching them per cell
+    void setLayers(int x, int y, TileType type, bool patchEdges = false)
+    {
+        const TileProperties& properties = getTileProperties(type);
+
+        if (m_blocksMovement.test(x, y) != properties.blocksMovement)
+        {
+            m_blocksMovement.set(x, y, properties.blocksMovement);
+            if (patchEdges)
+            {
+                m_movementEdges.patch(m_blocksMovement, x, y);
+            }
+        }
+        if (m_blocksVision.test(x, y) != properties.blocksVision)
+        {
+            m_blocksVision.set(x, y, properties.blocksVision);
+            if (patchEdges)
+            {
+                m_visionEdges.patch(m_blocksVision, x, y);
+            }
+        }
+    }
 
-    TileManager() = default;
+    void logEdit(int x, int y)
+    {
+        ++m_editGeneration;
+        if (m_editLog.size() >= maxLoggedEdits)
+        {
+            m_editLog.erase(m_editLog.begin(), m_editLog.begin() + static_cast<std::ptrdiff_t>(maxLoggedEdits / 2));
+        }
+        m_editLog.push_back({ Vec2i(x, y), m_editGeneration });
+    }
+
+    /// @brief get the chunk holding cell (x, y) for reading, loading it from disk if it was evicted
+    const Chunk& readChunk(int x, int y)
+    {
+        assert(inBounds(x, y));
 
-    std::vector<Tile>& getTiles()
+        const size_t index = chunkIndex(x >> chunkShift, y >> chunkShift);
+        Chunk& chunk = m_chunks[index];
+        if (chunk.state == ChunkState::EVICTED)
+        {
+            loadChunk(chunk, index);
+        }
+        return chunk;
+    }
+
+    static uint8_t cellShade(int x, int y)
     {
-        return m_tiles;
+        uint32_t h = static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(y) * 0xd8163841u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+        return static_cast<uint8_t>(h % 6u); // same [0, 5] range the old random shade used
     }
 
-    void addTile(const Tile& tile, int x, int y) /// TODO: look into adding tiles like emplace back instead of copying, if possible
+    void makeResident(Chunk& chunk, size_t index)
     {
-        m_tiles.data()[x * m_worldMaxCellsY + y] = tile;
+        chunk.state = ChunkState::DENSE;
+        m_residentChunks.push_back(index);
+    }
+
+    std::filesystem::path chunkPath(size_t index) const
+    {
+        return m_evictDirectory / (std::to_string(index) + ".chunk");
+    }
+
+    /// @return true if the chunk's memory was freed, a clean chunk is just dropped and a dirty one is written to disk first
+    bool evictChunk(Chunk& chunk, size_t index)
+    {
+        if (chunk.dirty)
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(m_evictDirectory, ec);
+
+            std::ofstream file(chunkPath(index), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(chunk.types.data()), static_cast<std::streamsize>(chunk.types.size()));
+            file.write(reinterpret_cast<const char*>(chunk.health.data()), static_cast<std::streamsize>(chunk.health.size()));
+            if (!file)
+            {
+                std::cerr << "Could not evict chunk " << index << " to " << chunkPath(index) << ", keeping it in memory\n";
+                return false;
+            }
+            chunk.dirty = false;
+            chunk.saved = true;
+        }
+
+        chunk.types.clear();
+        chunk.types.shrink_to_fit();
+        chunk.health.clear();
+        chunk.health.shrink_to_fit();
+        chunk.state = ChunkState::EVICTED;
+        return true;
+    }
+
+    void loadChunk(Chunk& chunk, size_t index)
+    {
+        chunk.types.resize(static_cast<size_t>(chunkSize * chunkSize));
+        chunk.health.resize(static_cast<size_t>(chunkSize * chunkSize));
+
+        if (chunk.saved)
+        {
+            std::ifstream file(chunkPath(index), std::ios::binary);
+            file.read(reinterpret_cast<char*>(chunk.types.data()), static_cast<std::streamsize>(chunk.types.size()));
+            file.read(reinterpret_cast<char*>(chunk.health.data()), static_cast<std::streamsize>(chunk.health.size()));
+            if (!file)
+            {
+                std::cerr << "Could not load evicted chunk " << index << " from " << chunkPath(index) << std::endl;
+                exit(-1);
+            }
+        }
+        else
+        {
+            readTypes(chunk, index, chunk.types);
+            for (size_t i = 0; i < chunk.types.size(); ++i)
+            {
+                chunk.health[i] = getTileProperties(chunk.types[i]).maxHealth;
+            }
+        }
+
+        makeResident(chunk, index);
+    }
+
+    /// @brief the types of an EVICTED chunk, from disk if it was saved and from the generator otherwise
+    void readTypes(const Chunk& chunk, size_t index, std::span<TileType> types) const
+    {
+        if (!chunk.saved)
+        {
+            const int cx = static_cast<int>(index % static_cast<size_t>(m_chunksX));
+            const int cy = static_cast<int>(index / static_cast<size_t>(m_chunksX));
+            m_generator->generateChunk(cx << chunkShift, cy << chunkShift, chunkSize, types);
+            return;
+        }
+
+        std::ifstream file(chunkPath(index), std::ios::binary);
+        file.read(reinterpret_cast<char*>(types.data()), static_cast<std::streamsize>(chunkSize * chunkSize));
+        if (!file)
+        {
+            std::cerr << "Could not load evicted chunk " << index << " from " << chunkPath(index) << std::endl;
+            exit(-1);
+        }
     }
 };
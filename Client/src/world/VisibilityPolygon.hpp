@@ -0,0 +1,230 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// World
+#include "TileBitset.hpp"
+#include "FloodFill.hpp"
+#include "EdgeCache.hpp"
+
+// Physics
+#include "physics/Vec2.hpp"
+
+// C++ standard libraries
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// @brief builds the visibility polygon (as a triangle fan) around an origin from merged tile edges
+/// @note rays are only cast at segment endpoints, everything between two endpoints is a straight edge so no other ray can add a vertex
+/// silhouette corners get two rays rotated just to either side, corners seen from the front get one ray aimed just inside the solid, and corners facing away get none
+class VisibilityPolygon
+{
+public:
+
+    static constexpr double epsilon = 0.0001; // radians the two rays at a silhouette corner are rotated by
+    static constexpr double aimOffset = 0.01; // pixels past a front-facing corner, into the solid, that its single ray is aimed at
+
+    /// @brief cast rays at the segment endpoints next to the filled area and the corners of the bounds, and sort the hits into a triangle fan around origin
+    /// @param segments vision edges around the bounds, endpoints with no filled open cell next to them are skipped
+    /// @param origin in pixels, must be inside the bounds
+    void build(const TileBitset& blocked, const FloodFill& fill, const std::vector<EdgeSegment>& segments, const Vec2f& origin, int minX, int maxX, int minY, int maxY, int cellSizePixels)
+    {
+        m_endpoints.clear();
+        for (const EdgeSegment& segment : segments)
+        {
+            m_endpoints.push_back(segment.a);
+            m_endpoints.push_back(segment.b);
+        }
+
+        // corners are shared by up to four segments, cast at each one once
+        std::sort(m_endpoints.begin(), m_endpoints.end(), [](const Vec2i& a, const Vec2i& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+        m_endpoints.erase(std::unique(m_endpoints.begin(), m_endpoints.end()), m_endpoints.end());
+
+        const Vec2<double> o = origin.to<double>();
+        const double cellSize = cellSizePixels;
+        const double cosEps = std::cos(epsilon);
+        const double sinEps = std::sin(epsilon);
+
+        auto cast = [&](const Vec2<double>& dir)
+        {
+            m_hits.push_back({ pseudoAngle(dir), castRay(blocked, o, dir, minX, maxX, minY, maxY, cellSize) });
+        };
+        auto castBothSides = [&](const Vec2<double>& d)
+        {
+            cast({ d.x * cosEps - d.y * sinEps, d.x * sinEps + d.y * cosEps });
+            cast({ d.x * cosEps + d.y * sinEps, -d.x * sinEps + d.y * cosEps });
+        };
+
+        m_hits.clear();
+
+        // corners of the bounds, rays there just leave the bounds
+        for (const Vec2i& corner : { Vec2i(minX, minY), Vec2i(maxX + 1, minY), Vec2i(minX, maxY + 1), Vec2i(maxX + 1, maxY + 1) })
+        {
+            castBothSides(corner.to<double>() * cellSize - o);
+        }
+
+        for (const Vec2i& endpoint : m_endpoints)
+        {
+            const Vec2<double> corner = endpoint.to<double>() * cellSize;
+            const Vec2<double> d = corner - o;
+            if (d.x == 0.0 && d.y == 0.0)
+            {
+                continue;
+            }
+
+            // the four cells around the corner, bit (qx + 1) + 2 * (qy + 1) of solidMask for the cell at endpoint + (qx, qy), qx, qy in { -1, 0 }
+            int solidCount = 0;
+            unsigned int solidMask = 0;
+            bool nextToFill = false; // corners of caves the player can't see into cast nothing
+            Vec2i solid, open; // quadrant offsets of the last solid and last open cell seen
+            for (int qy = -1; qy <= 0; ++qy)
+            {
+                for (int qx = -1; qx <= 0; ++qx)
+                {
+                    const int x = endpoint.x + qx;
+                    const int y = endpoint.y + qy;
+                    const bool inBounds = x >= minX && x <= maxX && y >= minY && y <= maxY;
+                    if (inBounds && blocked.test(x, y))
+                    {
+                        ++solidCount;
+                        solidMask |= 1u << ((qx + 1) + 2 * (qy + 1));
+                        solid = { qx, qy };
+                    }
+                    else
+                    {
+                        open = { qx, qy };
+                        nextToFill = nextToFill || (inBounds && fill.isVisited(x, y));
+                    }
+                }
+            }
+
+            if (!nextToFill || solidCount == 0 || solidCount == 4)
+            {
+                continue;
+            }
+
+            if (solidCount == 1 || solidCount == 3)
+            {
+                // faces meeting at the corner, normals point out of the solid, toward the open side
+                const Vec2i cell = solidCount == 1 ? solid : open;
+                const double sign = solidCount == 1 ? -1.0 : 1.0; // solid cell normals point away from it, open cell normals into it
+                const double nx = sign * (cell.x == -1 ? -1.0 : 1.0);
+                const double ny = sign * (cell.y == -1 ? -1.0 : 1.0);
+                const bool verticalFront = -d.x * nx > 0.0; // (origin - corner) dot normal
+                const bool horizontalFront = -d.y * ny > 0.0;
+
+                if (verticalFront && horizontalFront)
+                {
+                    // corner seen from the front, aim just inside the solid so the ray stops at the corner instead of grazing past it
+                    const Vec2<double> inside { solidCount == 1 ? (solid.x == -1 ? -aimOffset : aimOffset) : (open.x == -1 ? aimOffset : -aimOffset),
+                                                solidCount == 1 ? (solid.y == -1 ? -aimOffset : aimOffset) : (open.y == -1 ? aimOffset : -aimOffset) };
+                    cast(d + inside);
+                }
+                else if (solidCount == 1 && (verticalFront || horizontalFront))
+                {
+                    castBothSides(d); // silhouette, one ray stops at the corner and the other passes it
+                }
+                // otherwise the corner faces away from the origin and is hidden behind its own tiles
+            }
+            else if (solidMask == 0b1001u || solidMask == 0b0110u)
+            {
+                castBothSides(d); // two diagonal solid cells
+            }
+            // otherwise two solid cells side by side, a straight edge split at a chunk border
+        }
+
+        std::sort(m_hits.begin(), m_hits.end(), [](const Hit& a, const Hit& b) { return a.angle < b.angle; });
+
+        m_fan.clear();
+        m_fan.push_back(origin);
+        for (const Hit& hit : m_hits)
+        {
+            m_fan.push_back(hit.point);
+        }
+        if (!m_hits.empty())
+        {
+            m_fan.push_back(m_hits.front().point);
+        }
+    }
+
+    /// @brief origin followed by the hit points in angle order, closed by repeating the first hit
+    const std::vector<Vec2f>& getFan() const
+    {
+        return m_fan;
+    }
+
+    size_t getRayCount() const
+    {
+        return m_hits.size();
+    }
+
+private:
+
+    struct Hit
+    {
+        double angle;
+        Vec2f point;
+    };
+
+    std::vector<Vec2i> m_endpoints;
+    std::vector<Hit> m_hits;
+    std::vector<Vec2f> m_fan;
+
+    /// @brief monotonic in the angle of dir (clockwise from +x since +y points down), in [0, 4), without atan2
+    static double pseudoAngle(const Vec2<double>& dir)
+    {
+        const double p = dir.x / (std::abs(dir.x) + std::abs(dir.y));
+        return dir.y < 0.0 ? 3.0 + p : 1.0 - p;
+    }
+
+    /// @brief step cell by cell (DDA) from o along dir until a vision-blocking cell or the edge of the bounds
+    /// @return the point where the ray enters that cell or leaves the bounds, in pixels
+    static Vec2f castRay(const TileBitset& blocked, const Vec2<double>& o, const Vec2<double>& dir, int minX, int maxX, int minY, int maxY, double cellSize)
+    {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        Vec2i cell { static_cast<int>(std::floor(o.x / cellSize)), static_cast<int>(std::floor(o.y / cellSize)) };
+        const int stepX = dir.x < 0.0 ? -1 : 1;
+        const int stepY = dir.y < 0.0 ? -1 : 1;
+
+        // ray parameter t (point = o + t * dir) at the next vertical and horizontal grid line, and between grid lines
+        const double tDeltaX = dir.x != 0.0 ? cellSize / std::abs(dir.x) : infinity;
+        const double tDeltaY = dir.y != 0.0 ? cellSize / std::abs(dir.y) : infinity;
+        double tMaxX = dir.x > 0.0 ? ((cell.x + 1) * cellSize - o.x) / dir.x : dir.x < 0.0 ? (cell.x * cellSize - o.x) / dir.x : infinity;
+        double tMaxY = dir.y > 0.0 ? ((cell.y + 1) * cellSize - o.y) / dir.y : dir.y < 0.0 ? (cell.y * cellSize - o.y) / dir.y : infinity;
+
+        double t = 0.0;
+        while (true)
+        {
+            if (tMaxX < tMaxY)
+            {
+                t = tMaxX;
+                tMaxX += tDeltaX;
+                cell.x += stepX;
+                if (cell.x < minX || cell.x > maxX)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                t = tMaxY;
+                tMaxY += tDeltaY;
+                cell.y += stepY;
+                if (cell.y < minY || cell.y > maxY)
+                {
+                    break;
+                }
+            }
+
+            if (blocked.test(cell.x, cell.y))
+            {
+                break;
+            }
+        }
+
+        return Vec2f(static_cast<float>(o.x + t * dir.x), static_cast<float>(o.y + t * dir.y));
+    }
+};
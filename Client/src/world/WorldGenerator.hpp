@@ -10,19 +10,25 @@
 #include "TileType.hpp"
 #include "StructureTypes.hpp"
 
+// Physics
+#include "physics/Vec2.hpp"
+
 // Global
 #include "Timer.hpp"
-#include "Random.hpp"
 
 // C++ standard libraries
-#include <string>
 #include <vector>
-#include <iostream>
+#include <span>
+#include <random>
+#include <algorithm>
+#include <cassert>
 
 /// TODO: add biomes with specific rules for generation, could even define temp, humidity, etc. and calc tree density or water or weather or anything from them
 /// TODO: enum for tile types
 /// TODO: could add world evolution if I want people to be on same map for long time
 /// NOTE: if I use a certain seed, shit never changes, so can always get back to the same world
+/// @brief generates the world one square region at a time, every pass is a function of the cell and the seed so a region comes out the same however often it's generated
+/// @note building placements are drawn once up front from the seed, each region then only copies in the parts of the buildings that overlap it
 class WorldGenerator
 {
 public:
@@ -30,29 +36,63 @@ public:
     WorldGenerator(int numTilesX, int numTilesY, int worldSeed)
         : m_worldTilesX(numTilesX), m_worldTilesY(numTilesY), m_seed(worldSeed)
     {
-        m_noise.SetSeed(m_seed);
-        m_tileTypes.resize(static_cast<size_t>(m_worldTilesX * m_worldTilesY));
+        m_patchNoise.SetSeed(m_seed);
+        m_patchNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+        m_patchNoise.SetFrequency(0.02f);
+        m_patchNoise.SetFractalType(FastNoiseLite::FractalType_Ridged);
+        m_patchNoise.SetFractalOctaves(3);
+        m_patchNoise.SetFractalLacunarity(1.29f);
+        m_patchNoise.SetFractalGain(1.03f);
+        m_patchNoise.SetFractalWeightedStrength(-0.45f);
+        m_patchNoise.SetDomainWarpType(FastNoiseLite::DomainWarpType_OpenSimplex2Reduced);
+        m_patchNoise.SetDomainWarpAmp(12.5f);
+
+        // could do same as block patches but with SetFrequency(0.01f) and SetSeed(m_seed + 1)
+
+        // or could do this
+        m_caveNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+        m_caveNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+        m_caveNoise.SetSeed(m_seed);
+        m_caveNoise.SetFractalGain(0.55f);
+        // m_caveNoise.SetFractalLacunarity(2.2f);
+        // m_caveNoise.SetFractalWeightedStrength(-0.3f);
+        m_caveNoise.SetFractalOctaves(4);
+
+        placeBuildings();
     }
 
-    void generateWorld()
+    /// @brief generate the size x size square of cells with its top left at (x0, y0)
+    /// @param types row-major, types[(y - y0) * size + (x - x0)], at least size * size long; cells outside the world are left as they are
+    void generateChunk(int x0, int y0, int size, std::span<TileType> types) const
     {
         PROFILE_FUNCTION();
 
-        generateBaseLayer();
-        createBlockPatches();
-        // addBedrock();
-        addCaves();
-        addBuildings();
-        // createSkyline();
-    }
+        assert(types.size() >= static_cast<size_t>(size * size));
 
-    std::vector<TileType>& getTileTypes()
-    {
-        return m_tileTypes;
+        const Region region { x0, y0, std::min(x0 + size, m_worldTilesX), std::min(y0 + size, m_worldTilesY), size, types };
+        generateBaseLayer(region);
+        createBlockPatches(region);
+        // addBedrock(region);
+        addCaves(region);
+        addBuildings(region);
+        // createSkyline(region);
     }
 
 private:
 
+    /// @brief the cells a pass writes, x in [x0, xEnd) and y in [y0, yEnd), clipped to the world
+    struct Region
+    {
+        int x0, y0, xEnd, yEnd;
+        int stride;
+        std::span<TileType> types;
+
+        TileType& at(int x, int y) const
+        {
+            return types[static_cast<size_t>((y - y0) * stride + (x - x0))];
+        }
+    };
+
     int m_worldTilesX;
     int m_worldTilesY;
 
@@ -60,69 +100,49 @@ private:
 
     int m_seed;
 
-    FastNoiseLite m_noise;
+    FastNoiseLite m_patchNoise;
+    FastNoiseLite m_caveNoise;
 
-    std::vector<TileType> m_tileTypes;
+    StructureTypes m_structures;
+    std::vector<Vec2i> m_buildingBlocks; // top left of every hallway copied into the world, in the order they're copied so later ones overwrite earlier ones
 
-    /// TODO: try chunk-based storage for rendering and everything, but will use vector of pairs instead for now
-    // std::unordered_map<std::pair<int, int>, std::vector<std::vector<std::string>>> chunks;
-    // accessed like chunks[{chunkX, chunkY}][localX][localY] = ...;
-
-    /// @brief lay out dirt and stone layer, filling m_tilePositions
-    void generateBaseLayer()
+    /// @brief lay out dirt and stone layer
+    void generateBaseLayer(const Region& region) const
     {
-        PROFILE_FUNCTION();
-
-        std::cout << "Creating base layer..." << std::endl;
-
-        for (int y = 0; y < m_worldTilesY; ++y)
+        for (int y = region.y0; y < region.yEnd; ++y)
         {
-            for (int x = 0; x < m_worldTilesX; ++x)
+            for (int x = region.x0; x < region.xEnd; ++x)
             {
                 if (y <= m_worldTilesY * m_dirtToStone)
                 {
-                    m_tileTypes.data()[x * m_worldTilesY + y] = TileType::DIRT;
+                    region.at(x, y) = TileType::DIRT;
                 }
                 else
                 {
-                    m_tileTypes.data()[x * m_worldTilesY + y] = TileType::STONE;
+                    region.at(x, y) = TileType::STONE;
                 }
             }
         }
     }
 
     /// @brief add some dirt in stone and some stone in dirt
-    void createBlockPatches()
+    void createBlockPatches(const Region& region) const
     {
-        PROFILE_FUNCTION();
-
-        std::cout << "Creating block patches..." << std::endl;
-
-        m_noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-        m_noise.SetFrequency(0.02f);
-        m_noise.SetFractalType(FastNoiseLite::FractalType_Ridged);
-        m_noise.SetFractalOctaves(3);
-        m_noise.SetFractalLacunarity(1.29f);
-        m_noise.SetFractalGain(1.03f);
-        m_noise.SetFractalWeightedStrength(-0.45f);
-        m_noise.SetDomainWarpType(FastNoiseLite::DomainWarpType_OpenSimplex2Reduced);
-        m_noise.SetDomainWarpAmp(12.5f);
-
         float dirtThreshold = 0.6f; // threshold for creating dirt vein
         float stoneThreshold = 0.8f; // threshold for creating stone patch
 
-        for (int y = 0; y < m_worldTilesY; ++y)
+        for (int y = region.y0; y < region.yEnd; ++y)
         {
-            for (int x = 0; x < m_worldTilesX; ++x)
+            for (int x = region.x0; x < region.xEnd; ++x)
             {
-                float patchNoise = m_noise.GetNoise(static_cast<float>(x), static_cast<float>(y));
+                float patchNoise = m_patchNoise.GetNoise(static_cast<float>(x), static_cast<float>(y));
                 if (patchNoise > stoneThreshold && y <= m_worldTilesY * m_dirtToStone)
                 {
-                    m_tileTypes.data()[x * m_worldTilesY + y] = TileType::STONE;
+                    region.at(x, y) = TileType::STONE;
                 }
                 else if (patchNoise > dirtThreshold && y > m_worldTilesY * m_dirtToStone)
                 {
-                    m_tileTypes.data()[x * m_worldTilesY + y] = TileType::DIRT;
+                    region.at(x, y) = TileType::DIRT;
                 }
             }
         }
@@ -130,43 +150,23 @@ private:
 
     /// TODO:
     /// @brief add other things like bedrock veins
-    void addBedrock()
+    void addBedrock(const Region&) const
     {
-        PROFILE_FUNCTION();
-
-        std::cout << "Adding bedrock..." << std::endl;
-
     }
 
     /// TODO: Adding more sophisticated cave generation techniques, like cellular automata or Voronoi diagrams, could make your cave systems more organic and interesting
     /// @brief add caves
-    void addCaves()
+    void addCaves(const Region& region) const
     {
-        PROFILE_FUNCTION();
-
-        std::cout << "Adding caves..." << std::endl;
-
-        // could do same as block patches but with m_noise.SetFrequency(0.01f) and m_noise.SetSeed(m_seed + 1)
-
-        // or could do this
-        m_noise = FastNoiseLite();
-        m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-        m_noise.SetFractalType(FastNoiseLite::FractalType_FBm);
-        m_noise.SetSeed(m_seed);
-        m_noise.SetFractalGain(0.55f);
-        // m_noise.SetFractalLacunarity(2.2f);
-        // m_noise.SetFractalWeightedStrength(-0.3f);
-        m_noise.SetFractalOctaves(4);
-
         float caveThreshold = 0.05f; // threshold for creating caves
-        for (int y = 0; y < m_worldTilesY; ++y)
+        for (int y = region.y0; y < region.yEnd; ++y)
         {
-            for (int x = 0; x < m_worldTilesX; ++x)
+            for (int x = region.x0; x < region.xEnd; ++x)
             {
-                float caveNoise = m_noise.GetNoise(static_cast<float>(x), y * 1.5f);
+                float caveNoise = m_caveNoise.GetNoise(static_cast<float>(x), y * 1.5f);
                 if (caveNoise * (1.0f + 0.5f * y / m_worldTilesY) > caveThreshold)
                 {
-                    TileType& type = m_tileTypes.data()[x * m_worldTilesY + y];
+                    TileType& type = region.at(x, y);
                     if (type == TileType::DIRT)
                     {
                         type = TileType::DIRTWALL;
@@ -182,113 +182,72 @@ private:
         /// TODO: can look into different type of noise for this like rigid multifractal noise, can change thresholds for when a cave is made based on world y coord
     }
 
-    void addBuildings()
+    /// @brief pick where every building goes, each one is four hallways: one, one to its right, then two going down from that
+    /// @note drawn from the seed rather than the global RNG, a region has to get the same buildings every time it's generated
+    void placeBuildings()
     {
-        std::cout << "Adding buildings..." << std::endl;
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(m_seed));
+        std::uniform_int_distribution<int> randomX(0, m_worldTilesX); // left
+        std::uniform_int_distribution<int> randomY(0, m_worldTilesY); // top
+
+        const int structSizeX = static_cast<int>(m_structures.hallway.size());
+        const int structSizeY = static_cast<int>(m_structures.hallway[0].size());
 
-        StructureTypes structures;
         int numberOfBuildings = m_worldTilesX * m_worldTilesY / 50000;
         for (int i = 0; i < numberOfBuildings; ++i)
         {
             // int structType = random % numberOfBuildings;
-            int xPos = Random::getIntegral(0, m_worldTilesX); // left
-            int yPos = Random::getIntegral(0, m_worldTilesY); // top
-
-            int structSizeX = structures.hallway.size();
-            int structSizeY = structures.hallway[0].size();
-
-            for (int x = xPos; x < xPos + structSizeX; ++x)
-            {
-                if (x >= 0 && x < m_worldTilesX)
-                {
-                    for (int y = yPos; y < yPos + structSizeY; ++y)
-                    {
-                        if (y >= 0 && y < m_worldTilesY)
-                        {
-                            m_tileTypes.data()[x * m_worldTilesY + y] = structures.hallway.data()[x - xPos].data()[y - yPos];
-                        }
-                    }
-                }
-            }
+            int xPos = randomX(rng);
+            int yPos = randomY(rng);
+            m_buildingBlocks.emplace_back(xPos, yPos);
 
             // int structType = random % numberOfBuildings;
             xPos += structSizeX - 1;
-
-            for (int x = xPos; x < xPos + structSizeX; ++x)
-            {
-                if (x >= 0 && x < m_worldTilesX)
-                {
-                    for (int y = yPos; y < yPos + structSizeY; ++y)
-                    {
-                        if (y >= 0 && y < m_worldTilesY)
-                        {
-                            m_tileTypes.data()[x * m_worldTilesY + y] = structures.hallway.data()[x - xPos].data()[y - yPos];
-                        }
-                    }
-                }
-            }
+            m_buildingBlocks.emplace_back(xPos, yPos);
 
             yPos += structSizeY - 1;
-
-            for (int x = xPos; x < xPos + structSizeX; ++x)
-            {
-                if (x >= 0 && x < m_worldTilesX)
-                {
-                    for (int y = yPos; y < yPos + structSizeY; ++y)
-                    {
-                        if (y >= 0 && y < m_worldTilesY)
-                        {
-                            m_tileTypes.data()[x * m_worldTilesY + y] = structures.hallway.data()[x - xPos].data()[y - yPos];
-                        }
-                    }
-                }
-            }
+            m_buildingBlocks.emplace_back(xPos, yPos);
 
             yPos += structSizeY - 1;
+            m_buildingBlocks.emplace_back(xPos, yPos);
+        }
+    }
 
-            for (int x = xPos; x < xPos + structSizeX; ++x)
+    void addBuildings(const Region& region) const
+    {
+        const int structSizeX = static_cast<int>(m_structures.hallway.size());
+        const int structSizeY = static_cast<int>(m_structures.hallway[0].size());
+
+        for (const Vec2i& block : m_buildingBlocks)
+        {
+            for (int x = std::max(block.x, region.x0); x < std::min(block.x + structSizeX, region.xEnd); ++x)
             {
-                if (x >= 0 && x < m_worldTilesX)
+                for (int y = std::max(block.y, region.y0); y < std::min(block.y + structSizeY, region.yEnd); ++y)
                 {
-                    for (int y = yPos; y < yPos + structSizeY; ++y)
-                    {
-                        if (y >= 0 && y < m_worldTilesY)
-                        {
-                            m_tileTypes.data()[x * m_worldTilesY + y] = structures.hallway.data()[x - xPos].data()[y - yPos];
-                        }
-                    }
+                    region.at(x, y) = m_structures.hallway.data()[x - block.x].data()[y - block.y];
                 }
             }
         }
     }
 
     /// TODO: could improve it by incorporating some horizontal variation and adding more diversity in terms of terrain features above the sea level
-    void createSkyline()
+    void createSkyline(const Region& region) const
     {
-        PROFILE_FUNCTION();
-
-        std::cout << "Creating skyline..." << std::endl;
-
         // 1D noise for skyline along x-axis
-        std::vector<int> terrainHeights(static_cast<size_t>(m_worldTilesX)); /// @todo: consider using (u)int16_t or (u)int8_t for smaller heights and making its max val a global bound on world size in Globals.hpp, or std::array if fixed size wherever possible
-
         float terrainDelta = 50.0f; // controls max deviation from sea level
         float noiseScale = 1.0f;
         float seaLevel = m_worldTilesY / 5.0f; // number of tiles below the top of the screen
 
-        for (int x = 0; x < m_worldTilesX; ++x)
+        for (int x = region.x0; x < region.xEnd; ++x)
         {
-            float noiseVal = m_noise.GetNoise(x * noiseScale, 0.0f);
-            float extraNoise = m_noise.GetNoise(0.0f, x * noiseScale);
+            float noiseVal = m_caveNoise.GetNoise(x * noiseScale, 0.0f);
+            float extraNoise = m_caveNoise.GetNoise(0.0f, x * noiseScale);
             noiseVal += extraNoise;
-            terrainHeights.data()[x] = static_cast<int>(noiseVal * terrainDelta + seaLevel);
+            const int terrainHeight = static_cast<int>(noiseVal * terrainDelta + seaLevel);
 
-            for (int y = 0; y < m_worldTilesY; ++y)
+            for (int y = region.y0; y < std::min(region.yEnd, terrainHeight); ++y)
             {
-                if (y < terrainHeights.data()[x])
-                {
-                    m_tileTypes.data()[x * m_worldTilesY + y] = TileType::NONE;
-                }
+                region.at(x, y) = TileType::NONE;
             }
         }
 
@@ -0,0 +1,155 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// C++ Standard Libraries
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+
+/// @brief appends values of any bit width to a byte buffer, least significant bit first
+/// @note bytes are assembled with shifts, so the output is the same on little and big endian machines
+class BitWriter
+{
+public:
+
+    explicit BitWriter(std::vector<uint8_t>& bytes)
+        : m_bytes(bytes)
+    { }
+
+    /// @brief write the low bits of value
+    void write(uint32_t value, unsigned int bits)
+    {
+        assert(bits <= 32);
+        assert(bits == 32 || value < (uint64_t { 1 } << bits));
+
+        for (unsigned int written = 0; written < bits;)
+        {
+            const unsigned int bitInByte = m_bitCount & 7u;
+            if (bitInByte == 0)
+            {
+                m_bytes.push_back(0);
+            }
+
+            const unsigned int chunk = std::min(bits - written, 8u - bitInByte);
+            const uint32_t part = (value >> written) & ((1u << chunk) - 1u);
+            m_bytes.back() = static_cast<uint8_t>(m_bytes.back() | (part << bitInByte));
+
+            written += chunk;
+            m_bitCount += chunk;
+        }
+    }
+
+    void writeBool(bool value)
+    {
+        write(value ? 1u : 0u, 1);
+    }
+
+    /// @brief write value in 7 bit groups, each followed by a bit saying whether another group follows, so small values take 8 bits
+    void writeVarint(uint32_t value)
+    {
+        while (value >= 0x80u)
+        {
+            write(value & 0x7Fu, 7);
+            writeBool(true);
+            value >>= 7;
+        }
+        write(value, 7);
+        writeBool(false);
+    }
+
+    size_t getBitCount() const
+    {
+        return m_bitCount;
+    }
+
+private:
+
+    std::vector<uint8_t>& m_bytes; // bits past m_bitCount in the last byte are zero
+    size_t m_bitCount = 0;
+};
+
+/// @brief reads values written by BitWriter back out of a byte buffer
+/// @note reading past the end yields zeros and marks the reader failed instead of touching memory outside the buffer
+class BitReader
+{
+public:
+
+    BitReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_bitSize(size * 8)
+    { }
+
+    uint32_t read(unsigned int bits)
+    {
+        assert(bits <= 32);
+
+        if (m_bitCount + bits > m_bitSize)
+        {
+            m_failed = true;
+            m_bitCount = m_bitSize;
+            return 0;
+        }
+
+        uint32_t value = 0;
+        for (unsigned int read = 0; read < bits;)
+        {
+            const unsigned int bitInByte = m_bitCount & 7u;
+            const unsigned int chunk = std::min(bits - read, 8u - bitInByte);
+            const uint32_t part = (static_cast<uint32_t>(m_data[m_bitCount >> 3]) >> bitInByte) & ((1u << chunk) - 1u);
+            value |= part << read;
+
+            read += chunk;
+            m_bitCount += chunk;
+        }
+        return value;
+    }
+
+    bool readBool()
+    {
+        return read(1) != 0;
+    }
+
+    uint32_t readVarint()
+    {
+        uint32_t value = 0;
+        for (unsigned int shift = 0; shift < 35; shift += 7)
+        {
+            value |= read(7) << shift;
+            if (!readBool())
+            {
+                return value;
+            }
+        }
+
+        m_failed = true; // more groups than a 32 bit value needs
+        return 0;
+    }
+
+    /// @brief whether a read ran past the end of the buffer or found a value it couldn't have written
+    bool hasFailed() const
+    {
+        return m_failed;
+    }
+
+    /// @brief mark the data invalid, for decoders that find a value out of range
+    void fail()
+    {
+        m_failed = true;
+    }
+
+    /// @brief bits left to read, the last byte's padding included
+    size_t getBitsLeft() const
+    {
+        return m_bitSize - m_bitCount;
+    }
+
+private:
+
+    const uint8_t* m_data;
+    size_t m_bitSize;
+    size_t m_bitCount = 0;
+    bool m_failed = false;
+};
@@ -1,7 +1,18 @@
 #pragma once
 
+// C++ standard libraries
+#include <cstdint>
+
 using EntityID = unsigned int;
 
+/// @brief an entity slot plus the generation the slot had when the handle was made, stored where an Entity can't be (components, ID maps)
+/// @note once the entity is destroyed its slot's generation changes, so the handle stops resolving to a live entity instead of aliasing the slot's next one
+struct EntityHandle
+{
+    EntityID id = 0;
+    uint32_t generation = 0; // never a live generation
+};
+
 class EntityBase
 {
 public:
@@ -0,0 +1,143 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Global
+#include "NetworkDatum.hpp"
+#include "NetworkSerializer.hpp"
+#include "BitStream.hpp"
+
+// C++ Standard Libraries
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+/// @brief every datum queued for one peer and channel during a tick, sent as a single packet: a format version, a sequence number, and a datum count followed by the datums
+/// @note the packet is bit packed by NetworkSerializer, so it doesn't depend on NetworkDatum's layout or either machine's byte order
+/// the sequence number lets a receiver drop a batch that arrives after a newer one on an unreliable channel, see NetworkChannel.hpp
+/// clearing keeps the buffers' memory, so a batch reused every tick stops allocating once it has held a busy tick
+class NetworkBatch
+{
+public:
+
+    using Sequence = uint32_t;
+    static constexpr size_t maxDatums = std::numeric_limits<uint16_t>::max();
+
+    /// @brief append datum, flush the batch first if it's full
+    void add(const NetworkDatum& datum)
+    {
+        assert(!isFull());
+        m_datums.push_back(datum);
+    }
+
+    /// @brief pack the header and datums into the packet, stamped with its sender's sequence number for its channel, do this right before sending
+    void encode(Sequence sequence)
+    {
+        m_bytes.clear();
+        BitWriter writer(m_bytes);
+
+        writer.write(NetworkSerializer::version, 8);
+        writer.write(sequence, 32);
+        writer.writeVarint(static_cast<uint32_t>(m_datums.size()));
+        for (const NetworkDatum& datum : m_datums)
+        {
+            NetworkSerializer::write(writer, datum);
+        }
+    }
+
+    bool empty() const
+    {
+        return m_datums.empty();
+    }
+
+    bool isFull() const
+    {
+        return m_datums.size() == maxDatums;
+    }
+
+    size_t getCount() const
+    {
+        return m_datums.size();
+    }
+
+    /// @brief the packet contents, header included, valid after encode
+    const uint8_t* data() const
+    {
+        return m_bytes.data();
+    }
+
+    /// @brief packet size in bytes, header included, valid after encode
+    size_t size() const
+    {
+        return m_bytes.size();
+    }
+
+    void clear()
+    {
+        m_datums.clear();
+        m_bytes.clear();
+    }
+
+    /// @brief the sequence number of a received batch packet
+    /// @return false if the packet is too small to have one or was packed with another format version
+    static bool readSequence(const uint8_t* data, size_t size, Sequence& sequence)
+    {
+        BitReader reader(data, size);
+        return readHeader(reader, sequence);
+    }
+
+    /// @brief whether sequence comes after last, allowing for the counter wrapping around
+    static bool isNewer(Sequence sequence, Sequence last)
+    {
+        return static_cast<int32_t>(sequence - last) > 0;
+    }
+
+    /// @brief append the datums in a received batch packet to out
+    /// @return false if the packet is malformed or from another format version, nothing is appended then
+    static bool unpack(const uint8_t* data, size_t size, std::vector<NetworkDatum>& out)
+    {
+        BitReader reader(data, size);
+        Sequence sequence;
+        if (!readHeader(reader, sequence))
+        {
+            return false;
+        }
+
+        const uint32_t count = reader.readVarint();
+        if (reader.hasFailed() || count > maxDatums || count * size_t { NetworkSerializer::typeBits } > reader.getBitsLeft())
+        {
+            return false;
+        }
+
+        const size_t first = out.size();
+        out.resize(first + count);
+        for (size_t i = first; i < out.size(); ++i)
+        {
+            if (!NetworkSerializer::read(reader, out[i]))
+            {
+                out.resize(first);
+                return false;
+            }
+        }
+
+        if (reader.getBitsLeft() >= 8) // only the last byte's padding should be left
+        {
+            out.resize(first);
+            return false;
+        }
+        return true;
+    }
+
+private:
+
+    std::vector<NetworkDatum> m_datums;
+    std::vector<uint8_t> m_bytes; // the packed packet, filled by encode
+
+    static bool readHeader(BitReader& reader, Sequence& sequence)
+    {
+        const uint32_t version = reader.read(8);
+        sequence = reader.read(32);
+        return !reader.hasFailed() && version == NetworkSerializer::version;
+    }
+};
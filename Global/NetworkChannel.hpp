@@ -0,0 +1,51 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Global
+#include "NetworkDatum.hpp"
+
+// External libraries
+#include <enet/enet.h>
+
+// C++ Standard Libraries
+#include <cstdint>
+
+/// @brief which ENet channel each kind of datum travels on, and how it's delivered there
+/// @note state streams (POSITION, VELOCITY, SNAPSHOT) are resent every tick anyway, so they go unreliable and sequenced on their own channel where a lost packet is skipped instead of holding up the ones behind it
+/// lifecycle events (SPAWN, DESPAWN, WORLD_SEED, ...) happen once and must arrive, so they stay reliable on channel 0, except the lobby's own spawns and despawns, which ride in snapshots that are resent until acknowledged, see LobbyServer::takeSnapshot
+namespace NetworkChannel
+{
+    enum Channel : uint8_t
+    {
+        RELIABLE,
+        STATE,
+        NUM_CHANNELS // channels to allocate in enet_host_create and enet_host_connect
+    };
+
+    constexpr Channel of(NetworkDatum::DataType dataType)
+    {
+        switch (dataType)
+        {
+            case NetworkDatum::DataType::POSITION:
+            case NetworkDatum::DataType::VELOCITY:
+            case NetworkDatum::DataType::SNAPSHOT:
+                return STATE;
+
+            default:
+                return RELIABLE;
+        }
+    }
+
+    /// @brief ENet flags for packets on channel, no flags means unreliable but sequenced
+    constexpr enet_uint32 packetFlags(Channel channel)
+    {
+        return channel == RELIABLE ? ENET_PACKET_FLAG_RELIABLE : 0;
+    }
+
+    /// @brief whether a stale batch on channel should be dropped, reliable channels arrive in order and are never dropped
+    constexpr bool dropsStale(Channel channel)
+    {
+        return channel != RELIABLE;
+    }
+}
@@ -45,6 +45,10 @@ struct NetworkDatum
         // client-to-server: -
         LOBBY_CONNECT,
 
+        // server-to-client: first.id = lobby snapshot tick, the state datums after it in the batch are what changed since the client's last acknowledged snapshot
+        // client-to-server: first.id = newest snapshot tick applied (acknowledgement)
+        SNAPSHOT,
+
         // the number of data types (including NONE)
         NUM_TYPES
     }
@@ -115,6 +119,8 @@ inline std::ostream& operator<<(std::ostream& out, const NetworkDatum& netDatum)
         out << ", Seed: " << netDatum.first.i;
     else if (netDatum.dataType == NetworkDatum::DataType::LOBBY_CONNECT)
         out << ", Address:Port: " << netDatum.first.i << "." << netDatum.second.i << "." << netDatum.third.i << "." << netDatum.fourth.i << ":" << netDatum.fifth.i;
+    else if (netDatum.dataType == NetworkDatum::DataType::SNAPSHOT)
+        out << ", Tick: " << netDatum.first.id;
 
     return out;
 }
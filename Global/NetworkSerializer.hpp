@@ -0,0 +1,169 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Global
+#include "NetworkDatum.hpp"
+#include "BitStream.hpp"
+#include "EntityBase.hpp"
+#include "Globals.hpp"
+
+// C++ Standard Libraries
+#include <cstdint>
+#include <cmath>
+#include <bit>
+#include <algorithm>
+
+/// @brief the wire format of NetworkDatum, each data type packs only the fields it uses
+/// @note entity IDs are varints, positions are quantized to positionBits over the world's bounds, everything else keeps its full value
+/// bump version whenever a layout changes, NetworkBatch rejects packets with any other version
+class NetworkSerializer
+{
+public:
+
+    static constexpr uint8_t version = 2;
+
+    static constexpr unsigned int typeBits = 4;
+    static constexpr unsigned int entityTypeBits = 3;
+    static constexpr unsigned int positionBits = 20; // 40000 world pixels in 20 bits is about 1/26 of a pixel
+    static_assert(NetworkDatum::DataType::NUM_TYPES <= (1u << typeBits), "data types must fit in typeBits");
+    static_assert(EntityBase::Type::NUM_TYPES <= (1u << entityTypeBits), "entity types must fit in entityTypeBits");
+
+    static constexpr float worldMaxX = static_cast<float>(Settings::worldMaxCellsX * Settings::cellSizePixels);
+    static constexpr float worldMaxY = static_cast<float>(Settings::worldMaxCellsY * Settings::cellSizePixels);
+
+    static void write(BitWriter& writer, const NetworkDatum& datum)
+    {
+        writer.write(datum.dataType, typeBits);
+
+        switch (datum.dataType)
+        {
+            case NetworkDatum::DataType::POSITION:
+                writer.writeVarint(datum.first.id);
+                writer.write(quantize(datum.second.f, worldMaxX), positionBits);
+                writer.write(quantize(datum.third.f, worldMaxY), positionBits);
+                break;
+
+            case NetworkDatum::DataType::VELOCITY:
+                writer.writeVarint(datum.first.id);
+                writer.write(std::bit_cast<uint32_t>(datum.second.f), 32);
+                writer.write(std::bit_cast<uint32_t>(datum.third.f), 32);
+                break;
+
+            case NetworkDatum::DataType::SPAWN:
+                writer.writeVarint(datum.first.id);
+                writer.write(datum.second.type, entityTypeBits);
+                writer.write(quantize(datum.third.f, worldMaxX), positionBits);
+                writer.write(quantize(datum.fourth.f, worldMaxY), positionBits);
+                break;
+
+            case NetworkDatum::DataType::LOCAL_SPAWN:
+                writer.writeVarint(datum.first.id);
+                writer.writeVarint(datum.second.id);
+                break;
+
+            case NetworkDatum::DataType::DESPAWN:
+            case NetworkDatum::DataType::SNAPSHOT:
+                writer.writeVarint(datum.first.id);
+                break;
+
+            case NetworkDatum::DataType::WORLD_SEED:
+                writer.write(static_cast<uint32_t>(datum.first.i), 32);
+                break;
+
+            case NetworkDatum::DataType::LOBBY_CONNECT:
+                writer.write(static_cast<uint32_t>(datum.first.i), 8);
+                writer.write(static_cast<uint32_t>(datum.second.i), 8);
+                writer.write(static_cast<uint32_t>(datum.third.i), 8);
+                writer.write(static_cast<uint32_t>(datum.fourth.i), 8);
+                writer.write(static_cast<uint32_t>(datum.fifth.i), 16);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /// @return false if the reader ran out of bits or found a value no writer produces
+    static bool read(BitReader& reader, NetworkDatum& datum)
+    {
+        datum = NetworkDatum {};
+        const uint32_t dataType = reader.read(typeBits);
+        if (dataType >= NetworkDatum::DataType::NUM_TYPES)
+        {
+            reader.fail();
+            return false;
+        }
+        datum.dataType = static_cast<NetworkDatum::DataType>(dataType);
+
+        switch (datum.dataType)
+        {
+            case NetworkDatum::DataType::POSITION:
+                datum.first.id = reader.readVarint();
+                datum.second.f = dequantize(reader.read(positionBits), worldMaxX);
+                datum.third.f = dequantize(reader.read(positionBits), worldMaxY);
+                break;
+
+            case NetworkDatum::DataType::VELOCITY:
+                datum.first.id = reader.readVarint();
+                datum.second.f = std::bit_cast<float>(reader.read(32));
+                datum.third.f = std::bit_cast<float>(reader.read(32));
+                break;
+
+            case NetworkDatum::DataType::SPAWN:
+            {
+                datum.first.id = reader.readVarint();
+                const uint32_t type = reader.read(entityTypeBits);
+                if (type >= EntityBase::Type::NUM_TYPES)
+                {
+                    reader.fail();
+                }
+                datum.second.type = static_cast<EntityBase::Type>(type);
+                datum.third.f = dequantize(reader.read(positionBits), worldMaxX);
+                datum.fourth.f = dequantize(reader.read(positionBits), worldMaxY);
+                break;
+            }
+
+            case NetworkDatum::DataType::LOCAL_SPAWN:
+                datum.first.id = reader.readVarint();
+                datum.second.id = reader.readVarint();
+                break;
+
+            case NetworkDatum::DataType::DESPAWN:
+            case NetworkDatum::DataType::SNAPSHOT:
+                datum.first.id = reader.readVarint();
+                break;
+
+            case NetworkDatum::DataType::WORLD_SEED:
+                datum.first.i = static_cast<int>(reader.read(32));
+                break;
+
+            case NetworkDatum::DataType::LOBBY_CONNECT:
+                datum.first.i = static_cast<int>(reader.read(8));
+                datum.second.i = static_cast<int>(reader.read(8));
+                datum.third.i = static_cast<int>(reader.read(8));
+                datum.fourth.i = static_cast<int>(reader.read(8));
+                datum.fifth.i = static_cast<int>(reader.read(16));
+                break;
+
+            default:
+                break;
+        }
+
+        return !reader.hasFailed();
+    }
+
+    /// @brief map value in [0, max] to positionBits, values outside the world are clamped to its edge
+    static uint32_t quantize(float value, float max)
+    {
+        constexpr float steps = static_cast<float>((1u << positionBits) - 1u);
+        const float clamped = std::clamp(value, 0.0f, max);
+        return static_cast<uint32_t>(std::lround(clamped / max * steps));
+    }
+
+    static float dequantize(uint32_t value, float max)
+    {
+        constexpr float steps = static_cast<float>((1u << positionBits) - 1u);
+        return static_cast<float>(value) / steps * max;
+    }
+};
@@ -0,0 +1,311 @@
+// Copyright 2025, William MacDonald, All Rights Reserved.
+
+#pragma once
+
+// Server
+#include "ServerGlobals.hpp"
+#include "LobbyEntityManager.hpp"
+
+// Global
+#include "EntityBase.hpp"
+#include "NetworkDatum.hpp"
+#include "NetworkBatch.hpp"
+
+// C++ standard library
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+/// @brief which entities each client's snapshots include, the ones on a uniform grid over the world near the client's player
+/// @note an entity enters a client's interest within Settings::interestViewCells cells of its player and leaves only past Settings::interestLeaveCells, so one near the edge doesn't flap in and out
+/// entering and leaving are stamped with snapshot ticks like LobbyEntityManager's changes: a client gets a SPAWN for an entity that entered since its baseline and a DESPAWN for one that left
+class InterestManager
+{
+public:
+
+    using Tick = LobbyEntityManager::Tick;
+    static constexpr EntityID noViewer = std::numeric_limits<EntityID>::max();
+
+    explicit InterestManager(size_t clients)
+        : m_clients(clients)
+        , m_cells(static_cast<size_t>(cellsX * cellsY))
+    {
+        m_entityCells.fill(noCell);
+    }
+
+    /// @brief move every active entity to the cell of its current position, then update each client's interest around its viewer
+    /// @param viewers the entity each client sees from, indexed by client, noViewer for a client with nothing to see from yet
+    /// @param tick the snapshot being taken
+    void update(const LobbyEntityManager& entities, const std::vector<EntityID>& viewers, Tick tick)
+    {
+        assert(viewers.size() == m_clients.size());
+
+        const auto& state = entities.getCurrentState(); // auto since no access to array size
+        for (EntityID id : entities.getActiveEntities())
+        {
+            move(id, cellOf(state[id].third.f, state[id].fourth.f));
+        }
+
+        for (size_t client = 0; client < m_clients.size(); ++client)
+        {
+            ClientInterest& interest = m_clients[client];
+            const EntityID viewer = viewers[client];
+            const bool sees = viewer != noViewer && entities.isActive(viewer);
+            const int viewerCell = sees ? m_entityCells[viewer] : noCell;
+
+            // leave first, so the visible list only holds what stays when entering below
+            for (size_t i = 0; i < interest.visible.size();)
+            {
+                const EntityID id = interest.visible[i];
+                if (!sees || distance(m_entityCells[id], viewerCell) > Settings::interestLeaveCells)
+                {
+                    leave(interest, i, tick);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if (!sees)
+            {
+                continue;
+            }
+
+            const int viewerX = viewerCell % cellsX;
+            const int viewerY = viewerCell / cellsX;
+            for (int y = std::max(0, viewerY - Settings::interestViewCells); y <= std::min(cellsY - 1, viewerY + Settings::interestViewCells); ++y)
+            {
+                for (int x = std::max(0, viewerX - Settings::interestViewCells); x <= std::min(cellsX - 1, viewerX + Settings::interestViewCells); ++x)
+                {
+                    for (EntityID id : m_cells[static_cast<size_t>(y * cellsX + x)])
+                    {
+                        if (interest.entered[id] == 0 && !entities.isOwnedBy(id, client))
+                        {
+                            interest.entered[id] = tick;
+                            interest.visible.push_back(id);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief take id off the grid and out of every client's interest, call when it's destroyed
+    /// @param tick the first snapshot the entity is missing from
+    void remove(EntityID id, Tick tick)
+    {
+        move(id, noCell);
+
+        for (ClientInterest& interest : m_clients)
+        {
+            if (interest.entered[id] != 0)
+            {
+                leave(interest, static_cast<size_t>(std::find(interest.visible.begin(), interest.visible.end(), id) - interest.visible.begin()), tick);
+            }
+        }
+    }
+
+    /// @brief clear client's interest, for a client connecting to or disconnecting from its slot
+    void reset(size_t client)
+    {
+        m_clients[client] = ClientInterest();
+    }
+
+    /// @brief forget the leaves client has acknowledged, they're already despawned there
+    void acknowledge(size_t client, Tick baseline)
+    {
+        ClientInterest& interest = m_clients[client];
+        std::erase_if(interest.leaving, [&](EntityID id)
+            {
+                if (NetworkBatch::isNewer(interest.left[id], baseline))
+                {
+                    return false;
+                }
+                interest.left[id] = 0;
+                return true;
+            });
+    }
+
+    /// @brief append what client needs to go from snapshot baseline to the current state of the entities it's interested in
+    /// @param baseline the newest snapshot the client acknowledged, 0 for a client with nothing yet, which gets a full snapshot: a SPAWN per entity, positions included
+    /// @note the client may have applied snapshots newer than baseline too, so leaves since baseline are always sent and a SPAWN may repeat one it already has
+    /// that holds for a full snapshot as well, a client whose first acknowledgement was lost may have spawned an entity since gone, and a DESPAWN for one it never had is a no-op
+    void appendDelta(size_t client, Tick baseline, const LobbyEntityManager& entities, std::vector<NetworkDatum>& out) const
+    {
+        const ClientInterest& interest = m_clients[client];
+
+        // before any spawn, an entity that left and came back or a reused ID gets a DESPAWN then a SPAWN
+        for (EntityID id : interest.leaving)
+        {
+            if (NetworkBatch::isNewer(interest.left[id], baseline))
+            {
+                out.push_back(NetworkDatum { NetworkDatum::DataType::DESPAWN, .first.id = id });
+            }
+        }
+
+        const auto& state = entities.getCurrentState(); // auto since no access to array size
+        for (EntityID id : interest.visible)
+        {
+            const LobbyEntityManager::Changes& changes = entities.getChanges(id);
+            const bool spawn = baseline == 0 || NetworkBatch::isNewer(interest.entered[id], baseline); // an entity enters on or after the snapshot it spawns in
+            if (spawn)
+            {
+                out.push_back(state[id]);
+            }
+            else if (NetworkBatch::isNewer(changes.position, baseline))
+            {
+                out.push_back(NetworkDatum {
+                    NetworkDatum::DataType::POSITION,
+                    .first.id = id,
+                    .second.f = state[id].third.f,
+                    .third.f = state[id].fourth.f
+                });
+            }
+
+            if (changes.velocity != 0 && (spawn || NetworkBatch::isNewer(changes.velocity, baseline)))
+            {
+                out.push_back(entities.getVelocity(id));
+            }
+        }
+    }
+
+    /// @brief entities client is currently interested in
+    const std::vector<EntityID>& getVisible(size_t client) const
+    {
+        return m_clients[client].visible;
+    }
+
+    /// @brief whether a client whose first acknowledgement is lost still despawns an entity that left its interest or was destroyed meanwhile, checked once in debug builds, see LobbyServer
+    /// @note plays one client against one other entity: a full snapshot spawns the entity, its acknowledgement is dropped, the entity leaves, and the client acknowledges a later snapshot
+    static bool checkLostFirstAcknowledgement()
+    {
+        for (const bool destroy : { false, true })
+        {
+            LobbyEntityManager entities;
+            InterestManager interest(1);
+            const std::vector<EntityID> viewers { entities.addNetEntity(NetworkDatum { NetworkDatum::DataType::SPAWN, .second.type = EntityBase::Type::PLAYER, .third.f = 1000.0f, .fourth.f = 1000.0f }, 0, 1) };
+            const EntityID other = entities.addNetEntity(NetworkDatum { NetworkDatum::DataType::SPAWN, .second.type = EntityBase::Type::BULLET, .third.f = 1100.0f, .fourth.f = 1000.0f }, 1, 1); // owned by a client not in the check
+
+            // what the client has, applying every snapshot it receives
+            bool spawned = false;
+            Tick tick = 0;
+            Tick baseline = 0;
+            auto snapshot = [&]()
+            {
+                interest.update(entities, viewers, ++tick);
+                std::vector<NetworkDatum> delta;
+                interest.appendDelta(0, baseline, entities, delta);
+                for (const NetworkDatum& datum : delta)
+                {
+                    if (datum.first.id == other && datum.dataType == NetworkDatum::DataType::SPAWN)
+                    {
+                        spawned = true;
+                    }
+                    else if (datum.first.id == other && datum.dataType == NetworkDatum::DataType::DESPAWN)
+                    {
+                        spawned = false;
+                    }
+                }
+            };
+
+            snapshot(); // full, and its acknowledgement is lost
+            if (!spawned)
+            {
+                return false;
+            }
+
+            if (destroy)
+            {
+                interest.remove(other, tick + 1);
+                entities.destroy(other);
+            }
+            else
+            {
+                entities.setPosition(other, 1100.0f + static_cast<float>((Settings::interestLeaveCells + 1) * Settings::interestCellPixels), 1000.0f, tick + 1);
+            }
+            snapshot(); // still full
+
+            baseline = tick;
+            interest.acknowledge(0, baseline);
+            snapshot();
+
+            if (spawned)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+
+    static constexpr int noCell = -1;
+    static constexpr int cellsX = (Settings::worldMaxCellsX * Settings::cellSizePixels + Settings::interestCellPixels - 1) / Settings::interestCellPixels;
+    static constexpr int cellsY = (Settings::worldMaxCellsY * Settings::cellSizePixels + Settings::interestCellPixels - 1) / Settings::interestCellPixels;
+
+    /// @brief one client's interest, the per-entity vectors are indexed by entity ID
+    struct ClientInterest
+    {
+        std::vector<Tick> entered = std::vector<Tick>(Settings::worldMaxEntities, 0); // snapshot each entity last entered on, 0 while it's not of interest
+        std::vector<Tick> left = std::vector<Tick>(Settings::worldMaxEntities, 0); // snapshot each entity last left on, 0 once acknowledged
+        std::vector<EntityID> visible; // entities of interest
+        std::vector<EntityID> leaving; // entities with an unacknowledged leave
+    };
+
+    std::vector<ClientInterest> m_clients;
+    std::vector<std::vector<EntityID>> m_cells; // entities in each grid cell, row-major
+    std::array<int, Settings::worldMaxEntities> m_entityCells; // cell each entity is in, noCell when off the grid
+
+    static int cellOf(float x, float y)
+    {
+        const int cellX = std::clamp(static_cast<int>(x) / Settings::interestCellPixels, 0, cellsX - 1);
+        const int cellY = std::clamp(static_cast<int>(y) / Settings::interestCellPixels, 0, cellsY - 1);
+        return cellY * cellsX + cellX;
+    }
+
+    /// @brief cells between a and b counting diagonals as one, the grid's view is square like the screen's rather than round
+    static int distance(int a, int b)
+    {
+        return std::max(std::abs(a % cellsX - b % cellsX), std::abs(a / cellsX - b / cellsX));
+    }
+
+    void move(EntityID id, int cell)
+    {
+        const int from = m_entityCells[id];
+        if (from == cell)
+        {
+            return;
+        }
+
+        if (from != noCell)
+        {
+            std::vector<EntityID>& entities = m_cells[static_cast<size_t>(from)];
+            *std::find(entities.begin(), entities.end(), id) = entities.back();
+            entities.pop_back();
+        }
+        if (cell != noCell)
+        {
+            m_cells[static_cast<size_t>(cell)].push_back(id);
+        }
+        m_entityCells[id] = cell;
+    }
+
+    /// @brief take the entity at index in interest's visible list out of interest
+    static void leave(ClientInterest& interest, size_t index, Tick tick)
+    {
+        const EntityID id = interest.visible[index];
+        interest.visible[index] = interest.visible.back();
+        interest.visible.pop_back();
+        interest.entered[id] = 0;
+
+        if (interest.left[id] == 0)
+        {
+            interest.leaving.push_back(id);
+        }
+        interest.left[id] = tick;
+    }
+};
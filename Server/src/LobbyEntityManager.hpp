@@ -8,25 +8,37 @@
 // Global
 #include "EntityBase.hpp"
 #include "NetworkDatum.hpp"
+#include "NetworkBatch.hpp"
 
 // C++ standard library
 #include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
 #include <cassert>
 
+/// @brief the lobby's authoritative state of every net entity, stamped with the snapshot tick each part of it last changed on
+/// @note a snapshot is this state as of a tick, so a client's delta is everything stamped after the last snapshot it acknowledged, see InterestManager::appendDelta
 class LobbyEntityManager
 {
 public:
 
+    using Tick = NetworkBatch::Sequence; // snapshot number, 0 means none, compared allowing for wraparound like sequence numbers
+    static constexpr size_t noOwner = std::numeric_limits<size_t>::max();
+
     LobbyEntityManager()
     {
         for (EntityID id = 0; id < m_maxEntities; ++id)
         {
             m_freeList.push_back(id);
         }
+        m_owners.fill(noOwner);
     }
 
     /// @brief find and remove a free ID from the list of free IDs, return the ID
-    EntityID addNetEntity(NetworkDatum datum)
+    /// @param owner index of the client peer that spawned the entity, it's left out of that client's snapshots
+    /// @param tick the snapshot the entity first appears in
+    EntityID addNetEntity(NetworkDatum datum, size_t owner, Tick tick)
     {
         assert(!m_freeList.empty());
 
@@ -37,9 +49,13 @@ public:
         datum.first.id = id;
         if (datum.second.type == EntityBase::Type::PLAYER)
         {
-            datum.second.type = EntityBase::Type::ENEMY; // to send to future joining clients
+            datum.second.type = EntityBase::Type::ENEMY; // to send to other clients
         }
         m_currentState[id] = datum;
+        m_velocities[id] = NetworkDatum { NetworkDatum::DataType::VELOCITY, .first.id = id };
+        m_owners[id] = owner;
+        m_changes[id].position = tick;
+        m_changes[id].velocity = 0; // no velocity to send until the owner reports one
 
         // Add id to m_active
         m_active.push_back(id);
@@ -50,8 +66,11 @@ public:
     /// @brief add id to the list of free IDs
     void destroy(EntityID id)
     {
+        assert(isActive(id));
+
         // Add id to free list
         m_freeList.push_back(id);
+        m_owners[id] = noOwner;
 
         // Erase id from m_active
         auto it = std::find(m_active.begin(), m_active.end(), id);
@@ -61,6 +80,63 @@ public:
         }
     }
 
+    bool isActive(EntityID id) const
+    {
+        return id < m_maxEntities && m_owners[id] != noOwner;
+    }
+
+    /// @brief whether the client peer at index owner spawned id, only an owner may update its entity's state
+    bool isOwnedBy(EntityID id, size_t owner) const
+    {
+        return isActive(id) && m_owners[id] == owner;
+    }
+
+    /// @brief update id's position from its owner, the change goes out in snapshot tick
+    void setPosition(EntityID id, float x, float y, Tick tick)
+    {
+        assert(isActive(id));
+
+        NetworkDatum& state = m_currentState[id];
+        if (state.third.f != x || state.fourth.f != y)
+        {
+            state.third.f = x;
+            state.fourth.f = y;
+            m_changes[id].position = tick;
+        }
+    }
+
+    /// @brief update id's velocity from its owner, the change goes out in snapshot tick
+    void setVelocity(EntityID id, float x, float y, Tick tick)
+    {
+        assert(isActive(id));
+
+        NetworkDatum& velocity = m_velocities[id];
+        if (m_changes[id].velocity == 0 || velocity.second.f != x || velocity.third.f != y)
+        {
+            velocity.second.f = x;
+            velocity.third.f = y;
+            m_changes[id].velocity = tick;
+        }
+    }
+
+    /// @brief snapshot ticks an entity last changed on, 0 for never
+    struct Changes
+    {
+        Tick position = 0;
+        Tick velocity = 0;
+    };
+
+    const Changes& getChanges(EntityID id) const
+    {
+        return m_changes[id];
+    }
+
+    /// @brief id's VELOCITY datum, only meaningful once getChanges(id).velocity is set
+    const NetworkDatum& getVelocity(EntityID id) const
+    {
+        return m_velocities[id];
+    }
+
     const std::array<NetworkDatum, Settings::worldMaxEntities>& getCurrentState() const
     {
         return m_currentState;
@@ -77,7 +153,10 @@ private:
     std::vector<EntityID> m_freeList; // dynamic list tracking free IDs
     std::vector<EntityID> m_active; // dynamic list holding IDs of active entities for indexing current state
     /// @todo consider making this an unordered_map or smthn instead of an array for less memory usage
-    std::array<NetworkDatum, Settings::worldMaxEntities> m_currentState; // list of entity data to send to joining clients (SPAWN type)
+    std::array<NetworkDatum, Settings::worldMaxEntities> m_currentState; // SPAWN datum per entity, its position kept current
+    std::array<NetworkDatum, Settings::worldMaxEntities> m_velocities; // VELOCITY datum per entity
+    std::array<size_t, Settings::worldMaxEntities> m_owners; // peer index of the client that spawned each entity, noOwner for free IDs
+    std::array<Changes, Settings::worldMaxEntities> m_changes {};
 
     /// TODO: consider making an entity memory pool type thing but with only the network data I need to send to the clients to keep track of lots of state data like all tiles and entities' status, otherwise keep this method of using an array with all of it and the m_active vector
 };
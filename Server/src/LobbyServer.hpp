@@ -5,10 +5,13 @@
 // Server
 #include "ServerGlobals.hpp"
 #include "LobbyEntityManager.hpp"
+#include "InterestManager.hpp"
 
 // Global
 #include "Random.hpp"
 #include "NetworkDatum.hpp"
+#include "NetworkBatch.hpp"
+#include "NetworkChannel.hpp"
 #include "EntityBase.hpp"
 
 // External libraries
@@ -19,7 +22,9 @@
 #include <iostream>
 #include <limits>
 #include <cstring> // for std::memcpy
-#include <unordered_map>
+#include <array>
+#include <chrono>
+#include <cassert>
 
 /// @todo might need to add mutexes to this class for thread safety, but not sure yet
 class LobbyServer
@@ -32,12 +37,16 @@ public:
         address.host = ENET_HOST_ANY; // Accept connections from any IP address
         address.port = m_port;
 
-        m_server = enet_host_create(&address, m_maxPlayers, 2, 0, 0); // Create the ENet server
+        m_server = enet_host_create(&address, m_maxPlayers, NetworkChannel::NUM_CHANNELS, 0, 0); // Create the ENet server with a reliable and a state channel
         if (!m_server)
         {
             std::cerr << "LOBBY: Failed to create ENet server on port " << m_port << "\n";
             exit(1);
         }
+        m_peerChannels.resize(m_server->peerCount);
+        m_acknowledged.resize(m_server->peerCount);
+        m_players.resize(m_server->peerCount, InterestManager::noViewer);
+        assert(InterestManager::checkLostFirstAcknowledgement());
 
         std::cout << "LOBBY: Created, world seed initialized to: " << m_worldSeed << "\n";
     }
@@ -66,74 +75,44 @@ public:
                     // store client info here if needed with event.peer->data
 
                     ++m_numClients;
+                    m_peerChannels[peerIndex(event.peer)] = PeerChannels(); // sequences start over for a new client in this slot
+                    m_acknowledged[peerIndex(event.peer)] = 0; // entities around the client's player go out in its next snapshot, a full one until it acknowledges one
+                    m_interest.reset(peerIndex(event.peer));
 
                     // Send world seed to the new client
                     sendData(NetworkDatum { NetworkDatum::DataType::WORLD_SEED, .first.i = m_worldSeed }, event.peer);
 
-                    // Send SPAWN data for all existing entities to the new client
-                    /// TODO: look into how to batch all this data into a single packet to reduce network overhead
-                    const auto& currentState = m_lobbyEntityMan.getCurrentState(); // auto since no access to array size
-                    for (EntityID id : m_lobbyEntityMan.getActiveEntities())
-                    {
-                        sendData(currentState[id], event.peer);
-                    }
-
                     break;
                 }
 
                 case ENET_EVENT_TYPE_RECEIVE:
                 {
-                    NetworkDatum received;
-                    std::memcpy(&received, event.packet->data, sizeof(NetworkDatum));
-                    std::cout << "LOBBY: Received data: " << received << " from " << event.peer->address.host << ":" << event.peer->address.port << "\n";
-
-                    switch (received.dataType)
+                    // drop state batches older than one already received from this client, their datums are out of date
+                    const NetworkChannel::Channel channel = static_cast<NetworkChannel::Channel>(event.channelID);
+                    NetworkBatch::Sequence sequence;
+                    if (channel < NetworkChannel::NUM_CHANNELS && NetworkChannel::dropsStale(channel) && NetworkBatch::readSequence(event.packet->data, event.packet->dataLength, sequence))
                     {
-                        case NetworkDatum::DataType::POSITION:
-                            broadcastDataExcept(event.packet, event.peer);
-                            break;
-
-                        case NetworkDatum::DataType::VELOCITY:
-                            broadcastDataExcept(event.packet, event.peer);
-                            break;
-
-                        case NetworkDatum::DataType::SPAWN:
+                        NetworkBatch::Sequence& last = m_peerChannels[peerIndex(event.peer)].received[channel];
+                        if (!NetworkBatch::isNewer(sequence, last))
                         {
-                            EntityID netID = createNetEntity(received);
-
-                            if (received.second.type == EntityBase::Type::PLAYER)
-                            {
-                                m_client2PlayerID[concatenate(event.peer->address.host, event.peer->address.port)] = netID;
-
-                                received.second.type = EntityBase::Type::ENEMY;
-                            }
-
-                            // Send SPAWN to all but specific client
-                            NetworkDatum spawn {
-                                NetworkDatum::DataType::SPAWN,
-                                .first.id = netID,
-                                .second.type = received.second.type,
-                                .third.f = received.third.f,
-                                .fourth.f = received.fourth.f
-                            };
-                            broadcastDataExcept(spawn, event.peer);
-
-                            // Send LOCAL_SPAWN to specific client
-                            NetworkDatum localSpawn {
-                                NetworkDatum::DataType::LOCAL_SPAWN,
-                                .first.id = received.first.id,
-                                .second.id = netID
-                            };
-                            sendData(localSpawn, event.peer);
-
-                            // Clean up memory after processing message, careful not to clean memory in use or already cleaned memory cuz will seg fault
                             enet_packet_destroy(event.packet);
-
                             break;
                         }
+                        last = sequence;
+                    }
 
-                        default:
-                            break;
+                    m_received.clear();
+                    if (!NetworkBatch::unpack(event.packet->data, event.packet->dataLength, m_received))
+                    {
+                        std::cerr << "LOBBY: Received malformed packet of " << event.packet->dataLength << " bytes from " << event.peer->address.host << ":" << event.peer->address.port << "\n";
+                    }
+
+                    // Clean up memory after unpacking, every datum is copied out of the packet
+                    enet_packet_destroy(event.packet);
+
+                    for (NetworkDatum& received : m_received)
+                    {
+                        handleDatum(received, event.peer);
                     }
 
                     break;
@@ -143,20 +122,19 @@ public:
                 {
                     std::cout << "LOBBY: Client " << event.peer->address.host << ":" << event.peer->address.port << " disconnected\n";
 
-                    unsigned long key = concatenate(event.peer->address.host, event.peer->address.port);
-
-                    // Remove entity from current state
-                    m_lobbyEntityMan.destroy(m_client2PlayerID[key]);
-
-                    // Send despawn data to all connected clients
-                    NetworkDatum despawn {
-                        NetworkDatum::DataType::DESPAWN,
-                        .first.id = m_client2PlayerID[key]
-                    };
-                    broadcastData(despawn);
+                    // Remove entity from current state, the next snapshots of the clients that could see it despawn it
+                    EntityID& player = m_players[peerIndex(event.peer)];
+                    if (player != InterestManager::noViewer)
+                    {
+                        m_interest.remove(player, m_snapshotTick + 1);
+                        m_lobbyEntityMan.destroy(player);
+                        player = InterestManager::noViewer;
+                    }
 
-                    // Erase key-value pair for disconnected client
-                    m_client2PlayerID.erase(key);
+                    // Drop anything still queued for the client
+                    m_peerChannels[peerIndex(event.peer)] = PeerChannels();
+                    m_acknowledged[peerIndex(event.peer)] = 0;
+                    m_interest.reset(peerIndex(event.peer));
 
                     --m_numClients;
 
@@ -166,6 +144,15 @@ public:
                     break;
             }
         }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= m_nextSnapshot)
+        {
+            takeSnapshot();
+            m_nextSnapshot = std::max(m_nextSnapshot + snapshotPeriod, now); // skip snapshots missed while behind rather than sending a burst
+        }
+
+        flush();
     }
 
     bool isFull() const
@@ -185,76 +172,182 @@ private:
 
     LobbyEntityManager m_lobbyEntityMan;
     size_t m_numClients = 0;
-    std::unordered_map<unsigned long, EntityID> m_client2PlayerID;
+    std::vector<EntityID> m_players; // each client's player entity, which it sees the world from, InterestManager::noViewer until it spawns one, indexed like m_server->peers
     const size_t m_maxPlayers { Settings::maxLobbyPlayers };
+    InterestManager m_interest { m_maxPlayers }; // a client per peer, the host has m_maxPlayers of them
 
     const int m_worldSeed { Random::getIntegral(0, std::numeric_limits<int>::max()) };
 
-    EntityID createNetEntity(const NetworkDatum& datum)
+    /// @brief per-client batches and sequence numbers, one set per channel
+    struct PeerChannels
     {
-        return m_lobbyEntityMan.addNetEntity(datum);
-    }
-
-    void broadcastData(const NetworkDatum& data)
+        std::array<NetworkBatch, NetworkChannel::NUM_CHANNELS> outgoing; // datums queued this tick
+        std::array<NetworkBatch::Sequence, NetworkChannel::NUM_CHANNELS> sent {}; // last batch sent
+        std::array<NetworkBatch::Sequence, NetworkChannel::NUM_CHANNELS> received {}; // newest batch received
+    };
+
+    std::vector<PeerChannels> m_peerChannels; // indexed like m_server->peers
+    std::vector<NetworkDatum> m_received; // datums unpacked from the packet being handled
+
+    static constexpr std::chrono::steady_clock::duration snapshotPeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / Settings::snapshotRate;
+    std::chrono::steady_clock::time_point m_nextSnapshot = std::chrono::steady_clock::now();
+    LobbyEntityManager::Tick m_snapshotTick = 0; // last snapshot taken, changes received since go out in the next one
+    std::vector<LobbyEntityManager::Tick> m_acknowledged; // newest snapshot each client has acknowledged, 0 for none, indexed like m_server->peers
+    std::vector<NetworkDatum> m_delta; // a client's part of the snapshot being taken
+
+    /// @brief apply one datum received from peer to the lobby's state, it reaches the other clients in their snapshots
+    void handleDatum(NetworkDatum& received, ENetPeer* peer)
     {
-        std::cout << "LOBBY: Broadcasting data\n";
+        switch (received.dataType)
+        {
+            case NetworkDatum::DataType::POSITION:
+                if (m_lobbyEntityMan.isOwnedBy(received.first.id, peerIndex(peer)))
+                {
+                    m_lobbyEntityMan.setPosition(received.first.id, received.second.f, received.third.f, m_snapshotTick + 1);
+                }
+                break;
 
-        ENetPacket* packet = enet_packet_create(
-            &data,
-            sizeof(NetworkDatum),
-            ENET_PACKET_FLAG_RELIABLE
-        ); // reliable means guaranteed to be delivered
+            case NetworkDatum::DataType::VELOCITY:
+                if (m_lobbyEntityMan.isOwnedBy(received.first.id, peerIndex(peer)))
+                {
+                    m_lobbyEntityMan.setVelocity(received.first.id, received.second.f, received.third.f, m_snapshotTick + 1);
+                }
+                break;
 
-        if (!packet)
-        {
-            std::cerr << "LOBBY: Packet creation failed\n";
-            return;
-        }
+            case NetworkDatum::DataType::SNAPSHOT:
+            {
+                // acknowledgements arrive unreliably and out of order, keep the newest one for a snapshot actually taken
+                LobbyEntityManager::Tick& acknowledged = m_acknowledged[peerIndex(peer)];
+                if (NetworkBatch::isNewer(received.first.id, acknowledged) && !NetworkBatch::isNewer(received.first.id, m_snapshotTick))
+                {
+                    acknowledged = received.first.id;
+                    m_interest.acknowledge(peerIndex(peer), acknowledged);
+                }
+                break;
+            }
+
+            case NetworkDatum::DataType::SPAWN:
+            {
+                EntityID netID = createNetEntity(received, peer); // the other clients near it get it in their next snapshots
 
-        // queue packet for broadcast
-        enet_host_broadcast(m_server, 0, packet);
+                if (received.second.type == EntityBase::Type::PLAYER)
+                {
+                    m_players[peerIndex(peer)] = netID;
+                }
+
+                // Send LOCAL_SPAWN to specific client
+                NetworkDatum localSpawn {
+                    NetworkDatum::DataType::LOCAL_SPAWN,
+                    .first.id = received.first.id,
+                    .second.id = netID
+                };
+                sendData(localSpawn, peer);
 
-        // send out queued packets without dispatching any events
-        enet_host_flush(m_server);
+                break;
+            }
+
+            default:
+                break;
+        }
     }
 
-    void broadcastDataExcept(const NetworkDatum& data, ENetPeer* excludedPeer)
+    EntityID createNetEntity(const NetworkDatum& datum, const ENetPeer* owner)
     {
-        std::cout << "LOBBY: Broadcasting data to all peers except " << excludedPeer->address.host << ":" << excludedPeer->address.port << "\n";
+        return m_lobbyEntityMan.addNetEntity(datum, peerIndex(owner), m_snapshotTick + 1);
+    }
+
+    /// @brief close the current snapshot and queue each client what changed around its player since the last one it acknowledged, a client with nothing changed gets nothing
+    /// @note each client gets only the entities in its area of interest, so outbound traffic grows with the players near each other rather than with the square of the lobby's size
+    /// the delta goes unreliable on the state channel and is resent as part of every later delta until acknowledged, so it survives loss without reliable resends holding up newer state
+    void takeSnapshot()
+    {
+        static_assert(1 + 3 * size_t { Settings::worldMaxEntities } <= NetworkBatch::maxDatums, "a delta (a despawn, spawn and velocity per entity at most) must fit in one batch, a client acknowledges it as a whole");
+
+        ++m_snapshotTick;
+        m_interest.update(m_lobbyEntityMan, m_players, m_snapshotTick);
 
         for (size_t i = 0; i < m_server->peerCount; ++i)
         {
             ENetPeer* peer = &m_server->peers[i];
-            if (peer != excludedPeer && peer->state == ENET_PEER_STATE_CONNECTED)
+            if (peer->state != ENET_PEER_STATE_CONNECTED)
+            {
+                continue;
+            }
+
+            m_delta.clear();
+            m_interest.appendDelta(i, m_acknowledged[i], m_lobbyEntityMan, m_delta);
+            if (m_delta.empty())
+            {
+                continue;
+            }
+
+            sendData(NetworkDatum { NetworkDatum::DataType::SNAPSHOT, .first.id = m_snapshotTick }, peer, NetworkChannel::STATE);
+            for (const NetworkDatum& datum : m_delta)
             {
-                sendData(data, peer);
+                sendData(datum, peer, NetworkChannel::STATE);
             }
         }
     }
 
-    void broadcastDataExcept(ENetPacket* packet, ENetPeer* excludedPeer)
+    size_t peerIndex(const ENetPeer* peer) const
     {
-        std::cout << "LOBBY: Broadcasting data to all peers except " << excludedPeer->address.host << ":" << excludedPeer->address.port << "\n";
+        return static_cast<size_t>(peer - m_server->peers);
+    }
 
+    /// @brief queue data for a client, it goes out in one packet with everything else queued for the client this tick
+    void sendData(const NetworkDatum& data, ENetPeer* clientPeer)
+    {
+        sendData(data, clientPeer, NetworkChannel::of(data.dataType));
+    }
+
+    /// @brief queue data for a client on channel instead of its data type's usual one
+    void sendData(const NetworkDatum& data, ENetPeer* clientPeer, NetworkChannel::Channel channel)
+    {
+        NetworkBatch& batch = m_peerChannels[peerIndex(clientPeer)].outgoing[channel];
+        if (batch.isFull())
+        {
+            sendBatch(channel, clientPeer);
+        }
+        batch.add(data);
+    }
+
+    /// @brief send each client's queued datums as one packet per channel, then flush the host once for all of them
+    void flush()
+    {
+        bool sent = false;
         for (size_t i = 0; i < m_server->peerCount; ++i)
         {
             ENetPeer* peer = &m_server->peers[i];
-            if (peer != excludedPeer && peer->state == ENET_PEER_STATE_CONNECTED)
+            for (uint8_t channel = 0; channel < NetworkChannel::NUM_CHANNELS; ++channel)
             {
-                sendData(packet, peer);
+                NetworkBatch& batch = m_peerChannels[i].outgoing[channel];
+                if (!batch.empty() && peer->state == ENET_PEER_STATE_CONNECTED)
+                {
+                    sendBatch(static_cast<NetworkChannel::Channel>(channel), peer);
+                    sent = true;
+                }
+                batch.clear();
             }
         }
+
+        if (sent)
+        {
+            enet_host_flush(m_server);
+        }
     }
 
-    void sendData(const NetworkDatum& data, ENetPeer* clientPeer)
+    void sendBatch(NetworkChannel::Channel channel, ENetPeer* clientPeer)
     {
-        std::cout << "LOBBY: Sending data to client " << clientPeer->address.host << ":" << clientPeer->address.port << ": " << data << "\n";
+        PeerChannels& peerChannels = m_peerChannels[peerIndex(clientPeer)];
+        NetworkBatch& batch = peerChannels.outgoing[channel];
+        batch.encode(++peerChannels.sent[channel]);
 
         ENetPacket* packet = enet_packet_create(
-            &data,
-            sizeof(NetworkDatum),
-            ENET_PACKET_FLAG_RELIABLE
-        );
+            batch.data(),
+            batch.size(),
+            NetworkChannel::packetFlags(channel)
+        ); // reliable means guaranteed to be delivered, the state channel is unreliable but sequenced
+        batch.clear();
 
         if (!packet)
         {
@@ -262,28 +355,6 @@ private:
             return;
         }
 
-        enet_peer_send(clientPeer, 0, packet);
-        enet_host_flush(m_server);
-    }
-
-    void sendData(ENetPacket* packet, ENetPeer* clientPeer)
-    {
-        std::cout << "LOBBY: Sending data to client " << clientPeer->address.host << ":" << clientPeer->address.port << ": " << packet->data << "\n";
-
-        enet_peer_send(clientPeer, 0, packet);
-        enet_host_flush(m_server);
-    }
-
-    unsigned long concatenate(unsigned int x, unsigned int y)
-    {
-        x *= 10u;
-        unsigned int temp = y;
-        while (temp >= 10u)
-        {
-            temp /= 10u;
-            x *= 10u;
-        }
-
-        return x + y;
+        enet_peer_send(clientPeer, channel, packet);
     }
 };
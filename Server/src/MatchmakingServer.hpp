@@ -7,6 +7,8 @@
 
 // Global
 #include "NetworkDatum.hpp"
+#include "NetworkBatch.hpp"
+#include "NetworkChannel.hpp"
 
 // External libraries
 #include <enet/enet.h>
@@ -28,7 +30,7 @@ public:
         ENetAddress address;
         address.host = ENET_HOST_ANY; // Accept connections from any IP address (host: device connected to a network, both server and client are hosts)
         address.port = 5000; // Matchmaking port, listen for incoming connections on this port (port: number that IDs a specific process or service running on a host, clients must connects to this port)
-        m_server = enet_host_create(&address, 32, 2, 0, 0); // 32 clients and/or outgoing connections, 2 channels used (0 and 1, e.g., one for game state and one for chat), any amount of incoming bandwidth, any amount of outgoing bandwidth
+        m_server = enet_host_create(&address, 32, NetworkChannel::NUM_CHANNELS, 0, 0); // 32 clients and/or outgoing connections, the reliable and state channels (only the reliable one is used here), any amount of incoming bandwidth, any amount of outgoing bandwidth
         if (m_server == nullptr)
         {
             std::cerr << "MATCHMAKING: Failed to create matchmaking server" << std::endl;
@@ -81,11 +83,16 @@ public:
 
                 case ENET_EVENT_TYPE_RECEIVE:
                 {
-                    NetworkDatum received;
-                    std::memcpy(&received, event.packet->data, sizeof(NetworkDatum));
-                    std::cout << "MATCHMAKING: Received data: " << received << " from " << event.peer->address.host << ":" << event.peer->address.port << "\n";
+                    std::vector<NetworkDatum> received;
+                    NetworkBatch::unpack(event.packet->data, event.packet->dataLength, received); // clients send batches, see NetworkManager::flush
+                    enet_packet_destroy(event.packet);
 
-                    if (received.dataType == NetworkDatum::DataType::LOBBY_CONNECT)
+                    for (const NetworkDatum& datum : received)
+                    {
+                        std::cout << "MATCHMAKING: Received data: " << datum << " from " << event.peer->address.host << ":" << event.peer->address.port << "\n";
+                    }
+
+                    if (!received.empty() && received.front().dataType == NetworkDatum::DataType::LOBBY_CONNECT)
                     {
                         /// @todo change this from being hardcoded to 127.0.0.1
                         const LobbyServer* lobby = getFreeLoby();
@@ -134,9 +141,13 @@ private:
     {
         std::cout << "MATCHMAKING: Sending data to client at " << clientPeer->address.host << ":" << clientPeer->address.port << ": " << data << "\n";
 
+        NetworkBatch batch; // a batch of one, the format clients expect
+        batch.add(data);
+        batch.encode(0); // matchmaking replies are one-offs on a reliable channel, nothing to sequence
+
         ENetPacket* packet = enet_packet_create(
-            &data,
-            sizeof(NetworkDatum),
+            batch.data(),
+            batch.size(),
             ENET_PACKET_FLAG_RELIABLE
         );
 
@@ -146,7 +157,7 @@ private:
             return;
         }
 
-        enet_peer_send(clientPeer, 0, packet); // Send to a single client
+        enet_peer_send(clientPeer, NetworkChannel::RELIABLE, packet); // Send to a single client
         enet_host_flush(m_server);
     }
 
@@ -8,4 +8,10 @@
 namespace Settings
 {
     inline constexpr unsigned int maxLobbyPlayers = 50;
+    inline constexpr unsigned int snapshotRate = 60; // world snapshots each lobby sends its clients per second
+
+    // area of interest, see InterestManager
+    inline constexpr int interestCellPixels = 512; // side of a grid cell in world pixels
+    inline constexpr int interestViewCells = 3; // an entity within this many cells of a client's player enters its snapshots, half a 1920x1080 screen plus a cell of margin
+    inline constexpr int interestLeaveCells = interestViewCells + 1; // and leaves them only past this many, so one moving along the edge doesn't flap in and out
 }